@@ -0,0 +1,65 @@
+/**
+ * Counts heap allocations of a unit test, e.g. to check lookups do not allocate:
+ *
+ *     #include <appTest/AllocCounter.hpp>
+ *
+ *     const size_t before = had::allocations;
+ *     ...
+ *     REQUIRE(had::allocations == before);
+ *
+ * Replaces all forms of operator new and delete, so every new is paired
+ * with its own delete (sized, aligned and nothrow too).
+ * Replacements are not inline: include it in only one translation unit
+ * of each test executable.
+ *
+ * @author hdaniel@ualg.pt
+ * @version 0.1
+ * 19/10/2026.
+ */
+
+#ifndef __ALLOCCOUNTER_HPP__
+#define __ALLOCCOUNTER_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace had {
+
+	//number of operator new calls
+	inline size_t allocations = 0;
+
+	namespace allocCounter {
+		inline void *allocate(size_t n, size_t align = alignof(std::max_align_t)) {
+			++allocations;
+			n = (std::max<size_t>(n, 1) + align - 1) / align * align;
+			if (void *p = align <= alignof(std::max_align_t) ? std::malloc(n) : std::aligned_alloc(align, n)) return p;
+			throw std::bad_alloc();
+		}
+
+		inline void *allocate(size_t n, const std::nothrow_t &) noexcept {
+			try { return allocate(n); } catch (...) { return nullptr; }
+		}
+	}
+
+}
+
+void *operator new(size_t n) { return had::allocCounter::allocate(n); }
+void *operator new[](size_t n) { return had::allocCounter::allocate(n); }
+void *operator new(size_t n, std::align_val_t a) { return had::allocCounter::allocate(n, size_t(a)); }
+void *operator new[](size_t n, std::align_val_t a) { return had::allocCounter::allocate(n, size_t(a)); }
+void *operator new(size_t n, const std::nothrow_t &t) noexcept { return had::allocCounter::allocate(n, t); }
+void *operator new[](size_t n, const std::nothrow_t &t) noexcept { return had::allocCounter::allocate(n, t); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+#endif //__ALLOCCOUNTER_HPP__
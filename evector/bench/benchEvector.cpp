@@ -0,0 +1,65 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// evector benchmarks
+//
+#include <random>
+#include <stopwatch/benchmark.hpp>
+#include "evector.hpp"
+#include "slidingwindow.hpp"
+#include "convolution.hpp"
+#include "fixed.hpp"
+
+using namespace had;
+
+int main(int argc, char **argv) {
+	return Benchmark::main(argc, argv, [](Benchmark &bench) {
+		const size_t n = 1 << 20;
+		std::mt19937 gen(0);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		evector<double> v(n);
+		for (auto &x : v) x = dist(gen);
+		const uint64_t bytes = n * sizeof(double);
+
+		bench.run("evector::symmExt 1M +64+64", [&] {
+			evector<double> e = v;
+			e.symmExt(64, 64);
+			doNotOptimize(e.data());
+		}, bytes, n);
+
+		bench.run("evector::avg 1M", [&] {
+			double a = v.avg();
+			doNotOptimize(a);
+		}, bytes, n);
+
+		bench.run("SlidingWindow::mean 1M w=31", [&] {
+			doNotOptimize(SlidingWindow<double>::mean(v, 31).data());
+		}, bytes, n);
+
+		bench.run("SlidingWindow::max 1M w=31", [&] {
+			doNotOptimize(SlidingWindow<double>::max(v, 31).data());
+		}, bytes, n);
+
+		bench.run("SlidingWindow::median 1M w=31", [&] {
+			doNotOptimize(SlidingWindow<double>::median(v, 31).data());
+		}, bytes, n);
+
+		for (size_t taps : {32, 256}) {
+			evector<double> h(taps);
+			for (auto &x : h) x = dist(gen);
+			typedef Convolution<double> Conv;
+			bench.run("Convolution direct 1M k=" + std::to_string(taps), [&] {
+				doNotOptimize(Conv::convolve(v, h, Border::symmetric, Conv::Method::direct).data());
+			}, bytes, n);
+			bench.run("Convolution fft 1M k=" + std::to_string(taps), [&] {
+				doNotOptimize(Conv::convolve(v, h, Border::symmetric, Conv::Method::fft).data());
+			}, bytes, n);
+		}
+
+		evector<float> f(v.begin(), v.end());
+		evector<Q15> q = FixedVector::toFixed<Q15>(f);
+		bench.run("FixedVector::mul Q15 1M", [&] {
+			doNotOptimize(FixedVector::mul(q, q).data());
+		}, n * sizeof(Q15), n);
+	});
+}
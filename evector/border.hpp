@@ -0,0 +1,41 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+
+#ifndef __HAD_BORDER_HPP__
+#define __HAD_BORDER_HPP__
+
+#include "evector.hpp"
+
+namespace had {
+
+	/**
+	 * Boundary handling for filters that need samples beyond the signal ends
+	 *
+	 * valid:     no extension, only outputs where the window fits the signal
+	 * symmetric: extends signal with evector::symmExt(), output has signal size
+	 */
+	enum class Border { valid, symmetric };
+
+	/**
+	 * @param v      signal to extend
+	 * @param eb     number of elements to add at the beginning
+	 * @param ea     number of elements to add at the end
+	 * @param border boundary mode
+	 * @return copy of v extended according to border (v itself if Border::valid)
+	 *
+	 * PRE: v.size() > 0 if border != Border::valid
+	 */
+	template<typename T>
+	evector<T> extended(const evector<T> &v, int eb, int ea, Border border) {
+		evector<T> ret = v;
+		if (border == Border::symmetric)
+			ret.symmExt(eb, ea);
+		return ret;
+	}
+
+} //end namespace had
+
+#endif //__HAD_BORDER_HPP__
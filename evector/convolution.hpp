@@ -0,0 +1,149 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Convolution and cross-correlation of evectors
+//
+// Short kernels use a direct convolution blocked over outputs, so the
+// inner loop has independent outputs and is vectorized by the compiler.
+// Long kernels use FFT overlap-save: the signal is split in blocks of
+// N samples overlapping k-1, each one multiplied in frequency by the
+// kernel spectrum, which is computed only once.
+//
+// Borders follow SlidingWindow: Border::valid outputs n-k+1 samples,
+// Border::symmetric extends with evector::symmExt() and outputs n samples.
+//
+
+#ifndef __HAD_CONVOLUTION_HPP__
+#define __HAD_CONVOLUTION_HPP__
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include "evector.hpp"
+#include "border.hpp"
+#include "fft.hpp"
+
+namespace had {
+
+	template<typename T>
+	class Convolution {
+	public:
+		enum class Method { automatic, direct, fft };
+
+		//kernels shorter than this are convolved directly with Method::automatic
+		static constexpr size_t directMaxTaps = 64;
+
+	private:
+		/**
+		 * Valid convolution with reversed kernel, i.e. correlation:
+		 *   out[i] = sum_j h[j] * x[i+j],  i < nout
+		 */
+		static void direct(const double *x, size_t nout, const double *h, size_t k, double *out) {
+			constexpr size_t block = 256;
+			for (size_t b = 0; b < nout; b += block) {
+				const size_t len = std::min(block, nout - b);
+				double *o = out + b;
+				const double *xb = x + b;
+				std::fill(o, o + len, 0.0);
+				for (size_t j = 0; j < k; ++j) {
+					const double hj = h[j];
+					const double *xj = xb + j;
+					for (size_t i = 0; i < len; ++i)
+						o[i] += hj * xj[i];
+				}
+			}
+		}
+
+		/**
+		 * Same as direct() with FFT overlap-save
+		 */
+		static void overlapSave(const double *x, size_t nout, const double *h, size_t k, double *out) {
+			//block size: around 4 times the kernel, no larger than needed
+			size_t n = std::max<size_t>(std::bit_ceil(4 * k), 256);
+			n = std::max<size_t>(std::min(n, std::bit_ceil(nout + k - 1)), 2);
+			const size_t step = n - k + 1;
+
+			//kernel spectrum, h is reversed back to get a convolution
+			vector<double> buf(n, 0.0);
+			vector<FFT::cpx> H(n / 2 + 1), X(n / 2 + 1);
+			for (size_t j = 0; j < k; ++j) buf[j] = h[k - 1 - j];
+			FFT::forward(buf.data(), H.data(), n);
+
+			const size_t nin = nout + k - 1;
+			for (size_t s = 0; s < nout; s += step) {
+				const size_t avail = std::min(n, nin - s);
+				std::copy(x + s, x + s + avail, buf.begin());
+				std::fill(buf.begin() + avail, buf.end(), 0.0);
+
+				FFT::forward(buf.data(), X.data(), n);
+				for (size_t f = 0; f < X.size(); ++f)
+					X[f] = FFT::cpx(X[f].real() * H[f].real() - X[f].imag() * H[f].imag(),
+									X[f].real() * H[f].imag() + X[f].imag() * H[f].real());
+				FFT::inverse(X.data(), buf.data(), n);
+
+				//first k-1 outputs of circular convolution are aliased
+				const size_t len = std::min(step, nout - s);
+				std::copy(buf.begin() + k - 1, buf.begin() + k - 1 + len, out + s);
+			}
+		}
+
+		static evector<double> run(const evector<T> &v, const evector<T> &kernel, Border border,
+								   Method method, bool reverse) {
+			const size_t k = kernel.size();
+			if (k == 0) throw std::invalid_argument("Kernel must have size() > 0");
+
+			const int eb = (k - 1) / 2;
+			const int ea = k - 1 - eb;
+			evector<double> x;
+			if (border == Border::valid) x.assign(v.begin(), v.end());
+			else {
+				evector<T> e = extended(v, eb, ea, border);
+				x.assign(e.begin(), e.end());
+			}
+			if (x.size() < k) return evector<double>();
+
+			//kernels work as correlations, so convolution kernel is reversed
+			vector<double> h(kernel.begin(), kernel.end());
+			if (reverse) std::reverse(h.begin(), h.end());
+
+			const size_t nout = x.size() - k + 1;
+			evector<double> out(nout);
+			if (method == Method::automatic)
+				method = (k <= directMaxTaps) ? Method::direct : Method::fft;
+			if (method == Method::direct) direct(x.data(), nout, h.data(), k, out.data());
+			else overlapSave(x.data(), nout, h.data(), k, out.data());
+			return out;
+		}
+
+	public:
+		/**
+		 * out[i] = sum_j kernel[j] * v[i+k-1-j]  (v extended according to border)
+		 *
+		 * @param v      signal
+		 * @param kernel filter taps
+		 * @param border boundary mode
+		 * @param method direct, FFT or chosen by kernel size
+		 * @return convolution of v with kernel
+		 */
+		static evector<double> convolve(const evector<T> &v, const evector<T> &kernel,
+										Border border = Border::symmetric, Method method = Method::automatic) {
+			return run(v, kernel, border, method, true);
+		}
+
+		/**
+		 * out[i] = sum_j kernel[j] * v[i+j]  (v extended according to border)
+		 *
+		 * @see convolve() for parameters
+		 * @return cross-correlation of v with kernel
+		 */
+		static evector<double> correlate(const evector<T> &v, const evector<T> &kernel,
+										 Border border = Border::symmetric, Method method = Method::automatic) {
+			return run(v, kernel, border, method, false);
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_CONVOLUTION_HPP__
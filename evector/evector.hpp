@@ -52,6 +52,9 @@ An out-of-range access will throw an exception that the user can catch.
 */
 
 #include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <numeric>
 #include <vector>
 #include <cmath>  //get right version of std::abs for any type
  				  //if not will use cstdlib abs which is fr integers only
@@ -186,23 +189,26 @@ namespace had {
 
 		/**
 		*
+		* @param first begin of elements to print
+		* @param last end of elements to print
 		* @param sep separator character, default is a ASCII space
 		* @param prec precision
 		* @param fixedPrec fixed precision
-		* @return vector as a string
+		* @return elements in [first, last) as a string, formatted as to_string()
 		*/
-		friend string to_string(const evector<T>& v,
-						 const char sep = defaultSeparator,
-						 const int prec = defaultPrecision,
-						 const int fixedPrec = defaultFixedPrecision) {
+		template<typename It>
+		static string format(It first, It last,
+							 const char sep = defaultSeparator,
+							 const int prec = defaultPrecision,
+							 const int fixedPrec = defaultFixedPrecision) {
 			stringstream os;
 			//override default precisions
 			if (prec >= 0) os << setprecision(prec);
 			if (fixedPrec >= 0) os << fixed << setprecision(fixedPrec);
 
 			os << "[" << sep;
-			for (int i = 0; i < v.size(); ++i) {
-				double val = v[i];
+			for (; first != last; ++first) {
+				double val = *first;
 				//Avoid printing negative zero: -0.0 for very small number near zero
 
 				//use fabs(), cause cstdlib abs() will zero if -1 < val < 1 since is for integer
@@ -217,6 +223,20 @@ namespace had {
 			return os.str();
 		}
 
+		/**
+		*
+		* @param sep separator character, default is a ASCII space
+		* @param prec precision
+		* @param fixedPrec fixed precision
+		* @return vector as a string
+		*/
+		friend string to_string(const evector<T>& v,
+						 const char sep = defaultSeparator,
+						 const int prec = defaultPrecision,
+						 const int fixedPrec = defaultFixedPrecision) {
+			return format(v.begin(), v.end(), sep, prec, fixedPrec);
+		}
+
 		//Could use Named Parameter Idiom
 		//https://isocpp.org/wiki/faq/ctors#named-parameter-idiom
 		//see also project namedParIdiom on these folders
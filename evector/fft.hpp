@@ -0,0 +1,167 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Real FFT for power of 2 sizes
+//
+// n real samples are packed as n/2 complex samples, transformed with an
+// iterative radix-2 FFT and split into the n/2+1 bins of the real spectrum.
+// Plans (bit reversal and twiddle tables) are cached per thread, keyed by size,
+// so repeated transforms of the same size do not recompute them.
+//
+
+#ifndef __HAD_FFT_HPP__
+#define __HAD_FFT_HPP__
+
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <numbers>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace had {
+
+	class FFT {
+	public:
+		typedef std::complex<double> cpx;
+
+		/**
+		 * Tables for a real FFT of size n
+		 */
+		struct Plan {
+			size_t n;                      //real size
+			size_t m;                      //complex size, n/2
+			std::vector<uint32_t> bitrev;  //bit reversal permutation of m
+			std::vector<cpx> twiddle;      //e^(-2 pi i k/m), k < m/2
+			std::vector<cpx> rtwiddle;     //e^(-2 pi i k/n), k <= m
+
+			explicit Plan(size_t n) : n(n), m(n / 2), bitrev(m), twiddle(m / 2), rtwiddle(m + 1) {
+				const int bits = std::countr_zero(m);
+				for (size_t i = 0; i < m; ++i) {
+					uint32_t r = 0;
+					for (int b = 0; b < bits; ++b)
+						if (i & (size_t(1) << b)) r |= uint32_t(1) << (bits - 1 - b);
+					bitrev[i] = r;
+				}
+				for (size_t k = 0; k < m / 2; ++k)
+					twiddle[k] = std::polar(1.0, -2 * std::numbers::pi * k / m);
+				for (size_t k = 0; k <= m; ++k)
+					rtwiddle[k] = std::polar(1.0, -2 * std::numbers::pi * k / n);
+			}
+		};
+
+	private:
+		//complex product without NaN/Inf recovery path of std::complex operator*
+		static inline cpx mul(const cpx &a, const cpx &b) {
+			return { a.real() * b.real() - a.imag() * b.imag(),
+					 a.real() * b.imag() + a.imag() * b.real() };
+		}
+
+		/**
+		 * In place iterative radix-2 complex FFT of size p.m
+		 * Inverse is not scaled
+		 */
+		static void complexFFT(const Plan &p, cpx *z, bool inverse) {
+			const size_t m = p.m;
+			for (size_t i = 0; i < m; ++i)
+				if (i < p.bitrev[i]) std::swap(z[i], z[p.bitrev[i]]);
+
+			for (size_t len = 2; len <= m; len <<= 1) {
+				const size_t half = len / 2;
+				const size_t stride = m / len;
+				for (size_t b = 0; b < m; b += len) {
+					cpx *lo = z + b;
+					cpx *hi = lo + half;
+					for (size_t j = 0; j < half; ++j) {
+						cpx w = p.twiddle[j * stride];
+						if (inverse) w = std::conj(w);
+						const cpx t = mul(hi[j], w);
+						hi[j] = lo[j] - t;
+						lo[j] += t;
+					}
+				}
+			}
+		}
+
+	public:
+		/**
+		 * @param n transform size, power of 2 >= 2
+		 * @return cached plan for size n of calling thread
+		 */
+		static const Plan &plan(size_t n) {
+			if (n < 2 || !std::has_single_bit(n))
+				throw std::invalid_argument("FFT size must be a power of 2 >= 2");
+
+			thread_local std::unordered_map<size_t, std::unique_ptr<Plan>> cache;
+			auto &p = cache[n];
+			if (!p) p = std::make_unique<Plan>(n);
+			return *p;
+		}
+
+		/**
+		 * @param x    n real samples
+		 * @param X    output n/2+1 complex bins
+		 * @param n    transform size, power of 2
+		 */
+		static void forward(const double *x, cpx *X, size_t n) {
+			const Plan &p = plan(n);
+			const size_t m = p.m;
+
+			//pack even samples as real and odd as imaginary parts
+			for (size_t k = 0; k < m; ++k) X[k] = cpx(x[2 * k], x[2 * k + 1]);
+			complexFFT(p, X, false);
+
+			//split: X[k] = E[k] + W^k O[k]
+			const cpx z0 = X[0];
+			X[0] = cpx(z0.real() + z0.imag(), 0);
+			X[m] = cpx(z0.real() - z0.imag(), 0);
+			for (size_t k = 1; k <= m / 2; ++k) {
+				const cpx a = X[k];
+				const cpx b = std::conj(X[m - k]);
+				const cpx e = (a + b) * 0.5;
+				const cpx o = (a - b) * cpx(0, -0.5);
+				const cpx e2 = std::conj(e);    //E[m-k]
+				const cpx o2 = std::conj(o);    //O[m-k]
+				X[k] = e + mul(p.rtwiddle[k], o);
+				X[m - k] = e2 + mul(p.rtwiddle[m - k], o2);
+			}
+		}
+
+		/**
+		 * @param X    n/2+1 complex bins, overwritten
+		 * @param x    output n real samples (forward() is inverted, already scaled)
+		 * @param n    transform size, power of 2
+		 */
+		static void inverse(cpx *X, double *x, size_t n) {
+			const Plan &p = plan(n);
+			const size_t m = p.m;
+
+			//merge: E = (X[k] + conj(X[m-k]))/2, O = (X[k] - conj(X[m-k]))/2 W^-k, Z = E + iO
+			for (size_t k = 0; k <= m / 2; ++k) {
+				const cpx a = X[k];
+				const cpx b = std::conj(X[m - k]);
+				const cpx e = (a + b) * 0.5;
+				const cpx o = mul((a - b) * 0.5, std::conj(p.rtwiddle[k]));
+				//mirrored bin m-k
+				const cpx e2 = std::conj(e);
+				const cpx o2 = std::conj(o);
+				X[k] = e + cpx(-o.imag(), o.real());
+				if (k != m - k) X[m - k] = e2 + cpx(-o2.imag(), o2.real());
+			}
+			complexFFT(p, X, true);
+
+			const double scale = 1.0 / m;
+			for (size_t k = 0; k < m; ++k) {
+				x[2 * k] = X[k].real() * scale;
+				x[2 * k + 1] = X[k].imag() * scale;
+			}
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_FFT_HPP__
@@ -0,0 +1,277 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Fixed point element type for evectors
+//
+//   fixed<Rep, F>: integer Rep scaled by 2^-F, e.g.
+//     Q15 = fixed<int16_t, 15>, range [-1, 1) with 2 bytes per sample
+//     Q31 = fixed<int32_t, 31>, range [-1, 1) with 4 bytes per sample
+//     fixed<int16_t, 4>: 12 bit integer part with 4 fraction bits
+//
+// Arithmetic saturates instead of wrapping around. Values convert implicitly
+// to double, so evector<fixed<...>>::avg() and to_string() report scaled values.
+//
+// FixedVector has bulk saturating add/sub/mul and float conversion kernels,
+// with SSE2/SSSE3/AVX2 versions for Q15 when compiled for those targets.
+//
+
+#ifndef __HAD_FIXED_HPP__
+#define __HAD_FIXED_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "evector.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace had {
+
+	template<typename Rep, int F>
+	class fixed {
+		static_assert(std::is_integral_v<Rep> && std::is_signed_v<Rep> && sizeof(Rep) <= 4,
+					  "fixed<Rep, F> needs a signed integer Rep up to 32 bits");
+		static_assert(F >= 0 && F < int(sizeof(Rep) * 8), "fixed<Rep, F> fraction bits out of range");
+
+		//intermediate type wide enough for products
+		typedef std::conditional_t<sizeof(Rep) < 4, int32_t, int64_t> Wide;
+
+		Rep v = 0;
+
+		static constexpr Rep saturate(int64_t x) {
+			return static_cast<Rep>(std::clamp<int64_t>(x, std::numeric_limits<Rep>::min(),
+														std::numeric_limits<Rep>::max()));
+		}
+
+	public:
+		typedef Rep rep;
+		static constexpr int fractionBits = F;
+		static constexpr double scale = 1.0 / static_cast<double>(int64_t(1) << F);
+
+		constexpr fixed() = default;
+
+		/**
+		 * @param d value to represent, rounded to nearest and saturated
+		 */
+		explicit fixed(double d) {
+			const double s = d * static_cast<double>(int64_t(1) << F);
+			if (std::isnan(s)) v = 0;
+			else if (s >= static_cast<double>(std::numeric_limits<Rep>::max())) v = std::numeric_limits<Rep>::max();
+			else if (s <= static_cast<double>(std::numeric_limits<Rep>::min())) v = std::numeric_limits<Rep>::min();
+			else v = static_cast<Rep>(std::lround(s));
+		}
+
+		/**
+		 * @param r raw integer representation
+		 * @return fixed with raw value r
+		 */
+		static constexpr fixed fromRaw(Rep r) {
+			fixed f;
+			f.v = r;
+			return f;
+		}
+
+		constexpr Rep raw() const { return v; }
+
+		/**
+		 * @return scaled value
+		 */
+		constexpr operator double() const { return v * scale; }
+
+		friend constexpr fixed operator+(fixed a, fixed b) { return fromRaw(saturate(int64_t(a.v) + b.v)); }
+		friend constexpr fixed operator-(fixed a, fixed b) { return fromRaw(saturate(int64_t(a.v) - b.v)); }
+
+		/**
+		 * Product rounded to nearest (half up), as SSSE3 pmulhrsw for Q15
+		 */
+		friend constexpr fixed operator*(fixed a, fixed b) {
+			int64_t p = static_cast<int64_t>(Wide(a.v) * Wide(b.v));
+			if constexpr (F > 0) p = (p + (int64_t(1) << (F - 1))) >> F;
+			return fromRaw(saturate(p));
+		}
+
+		constexpr fixed operator-() const { return fromRaw(saturate(-int64_t(v))); }
+
+		constexpr fixed &operator+=(fixed b) { return *this = *this + b; }
+		constexpr fixed &operator-=(fixed b) { return *this = *this - b; }
+		constexpr fixed &operator*=(fixed b) { return *this = *this * b; }
+
+		friend constexpr bool operator==(fixed a, fixed b) { return a.v == b.v; }
+		friend constexpr auto operator<=>(fixed a, fixed b) { return a.v <=> b.v; }
+	};
+
+	typedef fixed<int16_t, 15> Q15;
+	typedef fixed<int32_t, 31> Q31;
+
+
+	class FixedVector {
+
+#if defined(__SSE2__)
+		//-1 * -1 is the only Q15 product that pmulhrsw does not saturate
+		static inline __m128i fixMulQ15(__m128i r, __m128i a, __m128i b) {
+			const __m128i min = _mm_set1_epi16(INT16_MIN);
+			const __m128i ovf = _mm_and_si128(_mm_cmpeq_epi16(a, min), _mm_cmpeq_epi16(b, min));
+			return _mm_xor_si128(r, ovf);
+		}
+#endif
+#if defined(__AVX2__)
+		static inline __m256i fixMulQ15(__m256i r, __m256i a, __m256i b) {
+			const __m256i min = _mm256_set1_epi16(INT16_MIN);
+			const __m256i ovf = _mm256_and_si256(_mm256_cmpeq_epi16(a, min), _mm256_cmpeq_epi16(b, min));
+			return _mm256_xor_si256(r, ovf);
+		}
+#endif
+
+		enum class Op { add, sub, mul };
+
+		/**
+		 * Q15 elementwise op, i is the first element not processed by SIMD
+		 */
+		static size_t simdQ15(const Q15 *a, const Q15 *b, Q15 *out, size_t n, Op op) {
+			size_t i = 0;
+			[[maybe_unused]] auto pa = reinterpret_cast<const char *>(a);
+			[[maybe_unused]] auto pb = reinterpret_cast<const char *>(b);
+			[[maybe_unused]] auto po = reinterpret_cast<char *>(out);
+#if defined(__AVX2__)
+			for (; i + 16 <= n; i += 16) {
+				const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + 2 * i));
+				const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + 2 * i));
+				__m256i r;
+				if (op == Op::add) r = _mm256_adds_epi16(x, y);
+				else if (op == Op::sub) r = _mm256_subs_epi16(x, y);
+				else r = fixMulQ15(_mm256_mulhrs_epi16(x, y), x, y);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(po + 2 * i), r);
+			}
+#endif
+#if defined(__SSE2__)
+			for (; i + 8 <= n; i += 8) {
+				const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pa + 2 * i));
+				const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pb + 2 * i));
+				__m128i r;
+				if (op == Op::add) r = _mm_adds_epi16(x, y);
+				else if (op == Op::sub) r = _mm_subs_epi16(x, y);
+	#if defined(__SSSE3__)
+				else r = fixMulQ15(_mm_mulhrs_epi16(x, y), x, y);
+	#else
+				else break;
+	#endif
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(po + 2 * i), r);
+			}
+#endif
+			return i;
+		}
+
+		template<typename Fx>
+		static evector<Fx> apply(const evector<Fx> &a, const evector<Fx> &b, Op op) {
+			if (a.size() != b.size()) throw std::length_error("FixedVector operands must have equal size()");
+			const size_t n = a.size();
+			evector<Fx> out(n);
+			size_t i = 0;
+			if constexpr (std::is_same_v<Fx, Q15>) i = simdQ15(a.data(), b.data(), out.data(), n, op);
+			for (; i < n; ++i)
+				out[i] = op == Op::add ? a[i] + b[i] : op == Op::sub ? a[i] - b[i] : a[i] * b[i];
+			return out;
+		}
+
+	public:
+		/**
+		 * @pre a.size() == b.size()
+		 * @return a + b elementwise, saturated
+		 */
+		template<typename Fx>
+		static evector<Fx> add(const evector<Fx> &a, const evector<Fx> &b) { return apply(a, b, Op::add); }
+
+		/**
+		 * @pre a.size() == b.size()
+		 * @return a - b elementwise, saturated
+		 */
+		template<typename Fx>
+		static evector<Fx> sub(const evector<Fx> &a, const evector<Fx> &b) { return apply(a, b, Op::sub); }
+
+		/**
+		 * @pre a.size() == b.size()
+		 * @return a * b elementwise, rounded and saturated
+		 */
+		template<typename Fx>
+		static evector<Fx> mul(const evector<Fx> &a, const evector<Fx> &b) { return apply(a, b, Op::mul); }
+
+		/**
+		 * @param v floating point samples
+		 * @return v converted to fixed point Fx, rounded to nearest and saturated
+		 */
+		template<typename Fx, typename T>
+		static evector<Fx> toFixed(const evector<T> &v) {
+			const size_t n = v.size();
+			evector<Fx> out(n);
+			size_t i = 0;
+#if defined(__SSE2__)
+			if constexpr (std::is_same_v<Fx, Q15> && std::is_same_v<T, float>) {
+				const __m128 s = _mm_set1_ps(32768.0f);
+				const __m128 hi = _mm_set1_ps(32767.0f);
+				const __m128 lo = _mm_set1_ps(-32768.0f);
+				const __m128 half = _mm_set1_ps(0.5f);
+				const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+				const __m128i one = _mm_set1_epi32(1);
+				//as fixed(double): NaN is 0, ties away from zero (lround), saturated
+				auto round = [&](__m128 x) {
+					x = _mm_mul_ps(x, s);
+					x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+					x = _mm_max_ps(_mm_min_ps(x, hi), lo);
+					const __m128i t = _mm_cvttps_epi32(x);
+					//fraction is exact: x - trunc(x)
+					const __m128 frac = _mm_and_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(t)), abs);
+					const __m128i up = _mm_and_si128(_mm_castps_si128(_mm_cmpge_ps(frac, half)), one);
+					const __m128i neg = _mm_castps_si128(_mm_cmplt_ps(x, _mm_setzero_ps()));
+					//+1 if positive, -1 if negative
+					return _mm_add_epi32(t, _mm_sub_epi32(_mm_xor_si128(up, neg), neg));
+				};
+				auto po = reinterpret_cast<char *>(out.data());
+				for (; i + 8 <= n; i += 8) {
+					const __m128i r = _mm_packs_epi32(round(_mm_loadu_ps(v.data() + i)), round(_mm_loadu_ps(v.data() + i + 4)));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(po + 2 * i), r);
+				}
+			}
+#endif
+			for (; i < n; ++i) out[i] = Fx(static_cast<double>(v[i]));
+			return out;
+		}
+
+		/**
+		 * @param v fixed point samples
+		 * @return v converted to floating point type T
+		 */
+		template<typename T, typename Fx>
+		static evector<T> toFloat(const evector<Fx> &v) {
+			const size_t n = v.size();
+			evector<T> out(n);
+			size_t i = 0;
+#if defined(__SSE2__)
+			if constexpr (std::is_same_v<Fx, Q15> && std::is_same_v<T, float>) {
+				const __m128 s = _mm_set1_ps(1.0f / 32768.0f);
+				auto pv = reinterpret_cast<const char *>(v.data());
+				for (; i + 8 <= n; i += 8) {
+					const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pv + 2 * i));
+					//sign extend int16 to int32
+					const __m128i x0 = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+					const __m128i x1 = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+					_mm_storeu_ps(out.data() + i, _mm_mul_ps(_mm_cvtepi32_ps(x0), s));
+					_mm_storeu_ps(out.data() + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(x1), s));
+				}
+			}
+#endif
+			for (; i < n; ++i) out[i] = static_cast<T>(static_cast<double>(v[i]));
+			return out;
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_FIXED_HPP__
@@ -0,0 +1,308 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Moving window filters over evectors
+//
+//   sum, mean, variance:  O(n) running accumulators
+//   min, max:             O(n) amortized with monotonic deque
+//   median, percentile:   O(n log w) with two ordered halves of the window
+//
+// Windows are centered: output i uses input [i-(w-1)/2, i+w/2].
+// With Border::symmetric the borders are extended with evector::symmExt()
+// semantics and output has the input size. With Border::valid only full
+// windows are computed, and output has size n-w+1.
+//
+// Independent segments of the output can be computed in parallel,
+// each segment reads its own w-1 overlapping input samples.
+//
+
+#ifndef __HAD_SLIDINGWINDOW_HPP__
+#define __HAD_SLIDINGWINDOW_HPP__
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <memory_resource>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include "evector.hpp"
+#include "border.hpp"
+
+namespace had {
+
+	template<typename T>
+	class SlidingWindow {
+
+		/**
+		 * Runs kernel on interior outputs, splitting them in segments
+		 * processed by different threads
+		 *
+		 * Kernel signature: void(const T* in, size_t nout, size_t w, R* out)
+		 * computes nout outputs from nout+w-1 inputs
+		 */
+		template<typename R, typename Kernel>
+		static void parallel(const T *in, size_t nout, size_t w, R *out, int threads, Kernel kernel) {
+			if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+			//not worth to spawn threads if segments are not much larger than window
+			if (threads == 1 || nout < static_cast<size_t>(threads) * w * 4) {
+				kernel(in, nout, w, out);
+				return;
+			}
+
+			const size_t chunk = (nout + threads - 1) / threads;
+			vector<std::thread> pool;
+			for (size_t b = 0; b < nout; b += chunk)
+				pool.emplace_back(kernel, in + b, std::min(chunk, nout - b), w, out + b);
+			for (auto &t : pool) t.join();
+		}
+
+		/**
+		 * Applies kernel to v, extending borders if needed
+		 *
+		 * Symmetric extension only needs the first and last w-1 outputs,
+		 * so only small head and tail copies of v are extended,
+		 * and the interior is computed from v directly
+		 */
+		template<typename R, typename Kernel>
+		static evector<R> run(const evector<T> &v, int w, Border border, int threads, Kernel kernel) {
+			if (w <= 0) throw std::invalid_argument("Window size must be > 0");
+			const size_t n = v.size();
+			const size_t ws = w;
+
+			if (border == Border::valid) {
+				evector<R> out(n >= ws ? n - ws + 1 : 0);
+				if (!out.empty()) parallel(v.data(), out.size(), ws, out.data(), threads, kernel);
+				return out;
+			}
+
+			const int eb = (w - 1) / 2;
+			const int ea = w - 1 - eb;
+			evector<R> out(n);
+
+			//small signals: extend all (also throws length_error if v is empty)
+			if (n < 2 * ws) {
+				evector<T> e = extended(v, eb, ea, border);
+				kernel(e.data(), n, ws, out.data());
+				return out;
+			}
+
+			//head: first eb outputs
+			evector<T> head(v.begin(), v.begin() + 2 * ws);
+			head.symmExt(eb, 0);
+			kernel(head.data(), eb, ws, out.data());
+
+			//interior: windows fully inside v
+			parallel(v.data(), n - ws + 1, ws, out.data() + eb, threads, kernel);
+
+			//tail: last ea outputs, first one starts at tail[w+1]
+			evector<T> tail(v.end() - 2 * ws, v.end());
+			tail.symmExt(0, ea);
+			kernel(tail.data() + ws + 1, ea, ws, out.data() + n - ea);
+
+			return out;
+		}
+
+		static void sumKernel(const T *in, size_t nout, size_t w, double *out) {
+			if (nout == 0) return;
+			double sum = 0;
+			for (size_t i = 0; i < w; ++i) sum += in[i];
+			out[0] = sum;
+			for (size_t i = 1; i < nout; ++i) {
+				sum += static_cast<double>(in[i + w - 1]) - static_cast<double>(in[i - 1]);
+				out[i] = sum;
+			}
+		}
+
+		/**
+		 * Welford on the first window, then sliding update:
+		 *   mean' = mean + (x-y)/w
+		 *   M2'   = M2 + (x-y)(x-mean' + y-mean)
+		 * where x enters and y leaves the window
+		 */
+		static void varianceKernel(const T *in, size_t nout, size_t w, double *out) {
+			if (nout == 0) return;
+			double mean = 0, m2 = 0;
+			for (size_t i = 0; i < w; ++i) {
+				const double x = in[i];
+				const double delta = x - mean;
+				mean += delta / (i + 1);
+				m2 += delta * (x - mean);
+			}
+			out[0] = std::max(m2, 0.0) / w;
+			for (size_t i = 1; i < nout; ++i) {
+				const double x = in[i + w - 1];
+				const double y = in[i - 1];
+				const double oldMean = mean;
+				mean += (x - y) / w;
+				m2 += (x - y) * (x - mean + y - oldMean);
+				out[i] = std::max(m2, 0.0) / w;
+			}
+		}
+
+		/**
+		 * Monotonic deque of indices kept in a power of 2 ring buffer.
+		 * Front is the extremum of current window.
+		 *
+		 * @param cmp strict order, std::less for min, std::greater for max
+		 */
+		template<typename Compare>
+		static void extremumKernel(const T *in, size_t nout, size_t w, T *out, Compare cmp) {
+			if (nout == 0) return;
+			const size_t mask = std::bit_ceil(w) - 1;
+			vector<size_t> dq(mask + 1);
+			size_t head = 0, count = 0;
+
+			const size_t n = nout + w - 1;
+			for (size_t i = 0; i < n; ++i) {
+				//drop front if it left the window
+				if (count > 0 && dq[head] + w <= i) {
+					head = (head + 1) & mask;
+					--count;
+				}
+				//drop back elements that can no longer be extremum
+				while (count > 0 && !cmp(in[dq[(head + count - 1) & mask]], in[i])) --count;
+				dq[(head + count) & mask] = i;
+				++count;
+
+				if (i + 1 >= w) out[i + 1 - w] = in[dq[head]];
+			}
+		}
+
+		/**
+		 * Window is split in two ordered halves:
+		 *   lo holds the rank+1 smallest elements, hi the remaining.
+		 * Result is the largest element of lo.
+		 * Tree nodes are recycled by a pool, so no allocations after the first window
+		 */
+		static void percentileKernel(const T *in, size_t nout, size_t w, T *out, size_t rank) {
+			if (nout == 0) return;
+			std::pmr::unsynchronized_pool_resource pool;
+			std::pmr::multiset<T> lo(&pool), hi(&pool);
+
+			auto rebalance = [&]() {
+				while (lo.size() > rank + 1) {
+					auto it = std::prev(lo.end());
+					hi.insert(*it);
+					lo.erase(it);
+				}
+				while (lo.size() < rank + 1 && !hi.empty()) {
+					auto it = hi.begin();
+					lo.insert(*it);
+					hi.erase(it);
+				}
+			};
+
+			auto insert = [&](const T &x) {
+				if (!lo.empty() && !(*lo.rbegin() < x)) lo.insert(x);
+				else hi.insert(x);
+			};
+
+			auto erase = [&](const T &y) {
+				if (!lo.empty() && !(*lo.rbegin() < y)) lo.erase(lo.find(y));
+				else hi.erase(hi.find(y));
+			};
+
+			for (size_t i = 0; i < w; ++i) {
+				insert(in[i]);
+				rebalance();
+			}
+			out[0] = *lo.rbegin();
+
+			for (size_t i = 1; i < nout; ++i) {
+				insert(in[i + w - 1]);
+				erase(in[i - 1]);
+				rebalance();
+				out[i] = *lo.rbegin();
+			}
+		}
+
+	public:
+
+		/**
+		 * @param v       signal
+		 * @param w       window size
+		 * @param border  boundary mode
+		 * @param threads number of threads, <= 0 uses all hardware threads
+		 * @return moving sum over windows of size w
+		 */
+		static evector<double> sum(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			return run<double>(v, w, border, threads, sumKernel);
+		}
+
+		/**
+		 * @return moving average over windows of size w
+		 * @see sum() for parameters
+		 */
+		static evector<double> mean(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			evector<double> ret = sum(v, w, border, threads);
+			for (auto &x : ret) x /= w;
+			return ret;
+		}
+
+		/**
+		 * @return moving (population) variance over windows of size w
+		 * @see sum() for parameters
+		 */
+		static evector<double> variance(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			return run<double>(v, w, border, threads, varianceKernel);
+		}
+
+		/**
+		 * @return moving minimum over windows of size w
+		 * @see sum() for parameters
+		 */
+		static evector<T> min(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			return run<T>(v, w, border, threads, [](const T *in, size_t nout, size_t w, T *out) {
+				extremumKernel(in, nout, w, out, std::less<T>());
+			});
+		}
+
+		/**
+		 * @return moving maximum over windows of size w
+		 * @see sum() for parameters
+		 */
+		static evector<T> max(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			return run<T>(v, w, border, threads, [](const T *in, size_t nout, size_t w, T *out) {
+				extremumKernel(in, nout, w, out, std::greater<T>());
+			});
+		}
+
+		/**
+		 * Nearest rank percentile: element at index round(p*(w-1))
+		 * of the sorted window
+		 *
+		 * @param p percentile in [0, 1]
+		 * @return moving percentile p over windows of size w
+		 * @throws invalid_argument if v has NaN: unordered, it cannot be ranked
+		 * @see sum() for other parameters
+		 */
+		static evector<T> percentile(const evector<T> &v, int w, double p,
+									 Border border = Border::symmetric, int threads = 1) {
+			if (!(p >= 0.0 && p <= 1.0)) throw std::invalid_argument("Percentile must be in [0, 1]");
+			if constexpr (std::is_floating_point_v<T>)
+				if (std::any_of(v.begin(), v.end(), [](T x) { return std::isnan(x); }))
+					throw std::invalid_argument("Percentile of NaN");
+			const size_t rank = w > 0 ? std::lround(p * (w - 1)) : 0;
+			return run<T>(v, w, border, threads, [rank](const T *in, size_t nout, size_t w, T *out) {
+				percentileKernel(in, nout, w, out, rank);
+			});
+		}
+
+		/**
+		 * @return moving median over windows of size w (upper median if w is even)
+		 * @throws invalid_argument if v has NaN
+		 * @see sum() for parameters
+		 */
+		static evector<T> median(const evector<T> &v, int w, Border border = Border::symmetric, int threads = 1) {
+			return percentile(v, w, 0.5, border, threads);
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_SLIDINGWINDOW_HPP__
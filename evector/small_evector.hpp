@@ -0,0 +1,253 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// evector with small buffer optimization
+//
+// Up to N elements are stored inline in the object, with no heap allocation.
+// Beyond N elements storage spills to the heap, growing geometrically.
+// Provides the same symmExt(), avg() and to_string() as evector,
+// and converts from and to evector<T>.
+//
+// Elements are moved with memcpy/memmove, so T must be trivially copyable
+// (arithmetic types, fixed point types, PODs).
+//
+
+#ifndef __HAD_SMALL_EVECTOR_HPP__
+#define __HAD_SMALL_EVECTOR_HPP__
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "evector.hpp"
+
+namespace had {
+
+	template<typename T, size_t N>
+	class small_evector {
+		static_assert(std::is_trivially_copyable_v<T>, "small_evector<T, N> needs a trivially copyable T");
+		static_assert(N > 0, "small_evector<T, N> needs N > 0");
+
+		alignas(T) unsigned char buf[N * sizeof(T)];
+		T *ptr = reinterpret_cast<T *>(buf);
+		size_t sz = 0;
+		size_t cap = N;
+
+		/**
+		 * Moves elements to a new heap buffer with capacity newcap
+		 */
+		void grow(size_t newcap) {
+			T *p = std::allocator<T>().allocate(newcap);
+			if (sz) std::memcpy(p, ptr, sz * sizeof(T));
+			release();
+			ptr = p;
+			cap = newcap;
+		}
+
+		void release() {
+			if (!isInline()) std::allocator<T>().deallocate(ptr, cap);
+			ptr = reinterpret_cast<T *>(buf);
+			cap = N;
+		}
+
+		void copyFrom(const T *first, size_t n) {
+			sz = 0;
+			reserve(n);
+			if (n) std::memcpy(ptr, first, n * sizeof(T));
+			sz = n;
+		}
+
+	public:
+		typedef T value_type;
+		typedef T *iterator;
+		typedef const T *const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		small_evector() = default;
+
+		explicit small_evector(size_t n, const T &value = T()) {
+			resize(n, value);
+		}
+
+		small_evector(std::initializer_list<T> il) { copyFrom(il.begin(), il.size()); }
+
+		template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+		small_evector(It first, It last) {
+			for (; first != last; ++first) push_back(*first);
+		}
+
+		small_evector(const evector<T> &v) { copyFrom(v.data(), v.size()); }
+
+		small_evector(const small_evector &o) { copyFrom(o.data(), o.size()); }
+
+		small_evector(small_evector &&o) noexcept { *this = std::move(o); }
+
+		~small_evector() { release(); }
+
+		small_evector &operator=(const small_evector &o) {
+			if (this != &o) copyFrom(o.data(), o.size());
+			return *this;
+		}
+
+		/**
+		 * Steals heap buffer of o, inline elements are copied
+		 */
+		small_evector &operator=(small_evector &&o) noexcept {
+			if (this == &o) return *this;
+			release();
+			if (o.isInline()) {
+				if (o.sz) std::memcpy(ptr, o.ptr, o.sz * sizeof(T));
+			}
+			else {
+				ptr = o.ptr;
+				cap = o.cap;
+				o.ptr = reinterpret_cast<T *>(o.buf);
+				o.cap = N;
+			}
+			sz = o.sz;
+			o.sz = 0;
+			return *this;
+		}
+
+		/**
+		 * @return copy as an evector
+		 */
+		operator evector<T>() const { return evector<T>(begin(), end()); }
+
+		/**
+		 * @return true if elements are stored inline (no heap allocation)
+		 */
+		bool isInline() const { return ptr == reinterpret_cast<const T *>(buf); }
+
+		size_t size() const { return sz; }
+		size_t capacity() const { return cap; }
+		bool empty() const { return sz == 0; }
+		static constexpr size_t inlineCapacity() { return N; }
+
+		T *data() { return ptr; }
+		const T *data() const { return ptr; }
+
+		iterator begin() { return ptr; }
+		iterator end() { return ptr + sz; }
+		const_iterator begin() const { return ptr; }
+		const_iterator end() const { return ptr + sz; }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		T &operator[](size_t i) { return ptr[i]; }
+		const T &operator[](size_t i) const { return ptr[i]; }
+		T &front() { return ptr[0]; }
+		const T &front() const { return ptr[0]; }
+		T &back() { return ptr[sz - 1]; }
+		const T &back() const { return ptr[sz - 1]; }
+
+		T &at(size_t i) {
+			if (i >= sz) throw std::out_of_range("small_evector::at() index out of range");
+			return ptr[i];
+		}
+		const T &at(size_t i) const { return const_cast<small_evector *>(this)->at(i); }
+
+		void reserve(size_t n) {
+			if (n > cap) grow(std::max(n, 2 * cap));
+		}
+
+		void resize(size_t n, const T &value = T()) {
+			reserve(n);
+			if (n > sz) std::fill(ptr + sz, ptr + n, value);
+			sz = n;
+		}
+
+		void clear() { sz = 0; }
+
+		void push_back(const T &value) {
+			if (sz == cap) {
+				const T v = value;  //value may be an element of this
+				grow(2 * cap);
+				ptr[sz++] = v;
+			}
+			else ptr[sz++] = value;
+		}
+
+		template<typename... Args>
+		T &emplace_back(Args &&... args) {
+			push_back(T(std::forward<Args>(args)...));
+			return back();
+		}
+
+		void pop_back() { --sz; }
+
+		/**
+		 * Extend vector, symmetric extension
+		 * Same as evector::symmExt()
+		 *
+		 * @param eb: number of elements to add at the beginning
+		 * @param ea: number of elements to add at the end
+		 *
+		 * PRE: this.size() > 0
+		 * Example: { 1, 2 }.symmExt(3,3) = { 2, 2, 1, 1, 2, 2, 1, 1}
+		 */
+		void symmExt(int eb, int ea) {
+			if (sz == 0)
+				throw std::length_error("Can only extend vectors with size() > 0");
+
+			//while extension is larger than vector, reflect the partially extended vector
+			reserve(sz + std::max(eb, 0) + std::max(ea, 0));
+			while (eb > 0) {
+				const size_t e = std::min<size_t>(eb, sz);
+				std::memmove(ptr + e, ptr, sz * sizeof(T));
+				for (size_t i = 0; i < e; ++i) ptr[i] = ptr[2 * e - 1 - i];
+				sz += e;
+				eb -= e;
+			}
+			while (ea > 0) {
+				const size_t e = std::min<size_t>(ea, sz);
+				for (size_t i = 0; i < e; ++i) ptr[sz + i] = ptr[sz - 1 - i];
+				sz += e;
+				ea -= e;
+			}
+		}
+
+		/**
+		 * @return average of vector
+		 */
+		double avg() const {
+			return std::accumulate(begin(), end(), 0.0) / sz;
+		}
+
+		/**
+		 * @see to_string(const evector<T>&, ...)
+		 */
+		friend string to_string(const small_evector &v, const char sep = ' ',
+								const int prec = -1, const int fixedPrec = -1) {
+			return evector<T>::format(v.begin(), v.end(), sep, prec, fixedPrec);
+		}
+
+		friend string to_string(const small_evector &v, const int prec) { return to_string(v, ' ', prec); }
+
+		friend bool operator==(const small_evector &a, const small_evector &b) {
+			return std::equal(a.begin(), a.end(), b.begin(), b.end());
+		}
+
+		friend bool operator==(const small_evector &a, const evector<T> &b) {
+			return std::equal(a.begin(), a.end(), b.begin(), b.end());
+		}
+	};
+
+
+	template<typename T, size_t N>
+	ostream &operator<<(ostream &os, const small_evector<T, N> &v) {
+		os << to_string(v);
+		return os;
+	}
+
+} //end namespace had
+
+#endif //__HAD_SMALL_EVECTOR_HPP__
@@ -0,0 +1,219 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Online statistics accumulator for streams of samples or evector chunks
+//
+// Moments are updated with Welford's algorithm and merged with
+// Chan et al. pairwise formulas, extended to 3rd and 4th moments by Pebay:
+//
+//   Chan, Golub, LeVeque, "Updating Formulae and a Pairwise Algorithm for Computing Sample Variances", 1979
+//   Pebay, "Formulas for Robust, One-Pass Parallel Computation of Covariances and Arbitrary-Order Statistical Moments", 2008
+//
+// Accumulators from different threads, files or shards can be merged,
+// and the result is the same as accumulating all samples in one.
+//
+
+#ifndef __HAD_STATS_HPP__
+#define __HAD_STATS_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include "evector.hpp"
+#include "tdigest.hpp"
+
+namespace had {
+
+	class StreamStats {
+		double n = 0;
+		double m1 = 0;      //mean
+		double m2 = 0;      //sum of squared deviations from mean
+		double m3 = 0;
+		double m4 = 0;
+		double minValue = std::numeric_limits<double>::infinity();
+		double maxValue = -std::numeric_limits<double>::infinity();
+		std::optional<TDigest> digest;
+
+	public:
+		/**
+		 * Accumulates moments, min and max only
+		 */
+		StreamStats() = default;
+
+		/**
+		 * Accumulates also a t-digest for quantile estimates
+		 *
+		 * @param compression t-digest compression, larger is more accurate
+		 */
+		explicit StreamStats(double compression) : digest(TDigest(compression)) { }
+
+		/**
+		 * @param x sample to add
+		 */
+		StreamStats &add(double x) {
+			const double n1 = n;
+			n += 1;
+			const double delta = x - m1;
+			const double deltan = delta / n;
+			const double deltan2 = deltan * deltan;
+			const double term1 = delta * deltan * n1;
+			m1 += deltan;
+			m4 += term1 * deltan2 * (n * n - 3 * n + 3) + 6 * deltan2 * m2 - 4 * deltan * m3;
+			m3 += term1 * deltan * (n - 2) - 3 * deltan * m2;
+			m2 += term1;
+
+			minValue = std::min(minValue, x);
+			maxValue = std::max(maxValue, x);
+			if (digest) digest->add(x);
+			return *this; //for method chain
+		}
+
+		/**
+		 * Chunk moments are computed with two passes over the chunk
+		 * (more accurate than sample by sample) and then merged
+		 *
+		 * @param v chunk of samples to add
+		 */
+		template<typename T>
+		StreamStats &add(const evector<T> &v) {
+			if (v.empty()) return *this;
+
+			StreamStats chunk;
+			chunk.n = v.size();
+			double sum = 0;
+			for (const auto &x : v) {
+				const double d = x;
+				sum += d;
+				chunk.minValue = std::min(chunk.minValue, d);
+				chunk.maxValue = std::max(chunk.maxValue, d);
+			}
+			chunk.m1 = sum / chunk.n;
+			for (const auto &x : v) {
+				const double d = static_cast<double>(x) - chunk.m1;
+				const double d2 = d * d;
+				chunk.m2 += d2;
+				chunk.m3 += d2 * d;
+				chunk.m4 += d2 * d2;
+			}
+			if (digest)
+				for (const auto &x : v) digest->add(x);
+
+			mergeMoments(chunk);
+			return *this; //for method chain
+		}
+
+		/**
+		 * Merges other accumulator into this.
+		 * Quantiles are kept only if both accumulate a t-digest
+		 *
+		 * @param other accumulator of another part of the stream
+		 */
+		StreamStats &merge(const StreamStats &other) {
+			mergeMoments(other);
+			if (digest) {
+				if (other.digest) digest->merge(*other.digest);
+				else if (other.n > 0) digest.reset();
+			}
+			return *this; //for method chain
+		}
+
+		StreamStats &operator+=(const StreamStats &other) { return merge(other); }
+
+		/**
+		 * @return number of samples
+		 */
+		size_t count() const { return static_cast<size_t>(n); }
+
+		/**
+		 * @return mean, NaN if empty
+		 */
+		double mean() const { return n > 0 ? m1 : std::numeric_limits<double>::quiet_NaN(); }
+
+		/**
+		 * @return population variance
+		 */
+		double variance() const { return n > 0 ? m2 / n : std::numeric_limits<double>::quiet_NaN(); }
+
+		/**
+		 * @return sample (unbiased) variance
+		 */
+		double sampleVariance() const { return n > 1 ? m2 / (n - 1) : std::numeric_limits<double>::quiet_NaN(); }
+
+		/**
+		 * @return population standard deviation
+		 */
+		double stddev() const { return std::sqrt(variance()); }
+
+		/**
+		 * @return population skewness
+		 */
+		double skewness() const { return std::sqrt(n) * m3 / std::pow(m2, 1.5); }
+
+		/**
+		 * @return population excess kurtosis (0 for normal distribution)
+		 */
+		double kurtosis() const { return n * m4 / (m2 * m2) - 3; }
+
+		double min() const { return minValue; }
+		double max() const { return maxValue; }
+
+		/**
+		 * Merges points buffered in the t-digest, if any:
+		 * next quantile() calls do not copy it
+		 */
+		StreamStats &flush() {
+			if (digest) digest->flush();
+			return *this;
+		}
+
+		/**
+		 * @param q quantile in [0, 1]
+		 * @return estimated value at quantile q
+		 * @throw logic_error if not accumulating a t-digest
+		 */
+		double quantile(double q) const {
+			if (!digest) throw std::logic_error("StreamStats has no t-digest for quantiles");
+			return digest->quantile(q);
+		}
+
+	private:
+		void mergeMoments(const StreamStats &b) {
+			if (b.n == 0) return;
+			if (n == 0) {
+				n = b.n; m1 = b.m1; m2 = b.m2; m3 = b.m3; m4 = b.m4;
+				minValue = b.minValue;
+				maxValue = b.maxValue;
+				return;
+			}
+
+			const double na = n, nb = b.n;
+			const double nt = na + nb;
+			const double delta = b.m1 - m1;
+			const double delta2 = delta * delta;
+			const double delta3 = delta2 * delta;
+			const double delta4 = delta2 * delta2;
+
+			const double m4t = m4 + b.m4
+							   + delta4 * na * nb * (na * na - na * nb + nb * nb) / (nt * nt * nt)
+							   + 6 * delta2 * (na * na * b.m2 + nb * nb * m2) / (nt * nt)
+							   + 4 * delta * (na * b.m3 - nb * m3) / nt;
+			const double m3t = m3 + b.m3
+							   + delta3 * na * nb * (na - nb) / (nt * nt)
+							   + 3 * delta * (na * b.m2 - nb * m2) / nt;
+			m2 += b.m2 + delta2 * na * nb / nt;
+			m1 += delta * nb / nt;
+			m3 = m3t;
+			m4 = m4t;
+			n = nt;
+			minValue = std::min(minValue, b.minValue);
+			maxValue = std::max(maxValue, b.maxValue);
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_STATS_HPP__
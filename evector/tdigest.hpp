@@ -0,0 +1,220 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// v1.0
+//
+// Merging t-digest for streaming quantile estimates
+//
+// Ted Dunning, Otmar Ertl, "Computing Extremely Accurate Quantiles Using t-Digests"
+// https://arxiv.org/abs/1902.04023
+//
+// Points are buffered and merged into centroids, sorted by mean, whenever
+// the buffer fills. Centroid sizes are bounded by the k1 scale function,
+// so tails are kept with more resolution than the center.
+// Digests from different streams can be merged.
+//
+// Const queries do not modify the digest: concurrent queries are safe.
+// With points still buffered they merge a copy; call flush() after the
+// last add() to merge once and query without copies.
+//
+
+#ifndef __HAD_TDIGEST_HPP__
+#define __HAD_TDIGEST_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace had {
+
+	class TDigest {
+		struct Centroid {
+			double mean;
+			double weight;
+			bool operator<(const Centroid &c) const { return mean < c.mean; }
+		};
+
+		double compression;
+		size_t bufferSize;
+
+		std::vector<Centroid> centroids;
+		std::vector<Centroid> buffer;
+		double total = 0;   //weight merged in centroids
+
+		double minValue = std::numeric_limits<double>::infinity();
+		double maxValue = -std::numeric_limits<double>::infinity();
+
+		//k1 scale function and its inverse
+		double k(double q) const {
+			return compression / (2 * std::numbers::pi) * std::asin(2 * q - 1);
+		}
+		double kinv(double kv) const {
+			const double x = kv * 2 * std::numbers::pi / compression;
+			if (x >= std::numbers::pi / 2) return 1.0;
+			return (std::sin(x) + 1) / 2;
+		}
+
+		/**
+		 * Merges points into centroids, bounded by the scale function
+		 *
+		 * @param points centroids and buffered points, sorted here
+		 * @param out    merged centroids
+		 * @return total weight
+		 */
+		double merge(std::vector<Centroid> &points, std::vector<Centroid> &out) const {
+			std::sort(points.begin(), points.end());
+			double all = 0;
+			for (auto &c : points) all += c.weight;
+
+			out.clear();
+			Centroid cur = points[0];
+			double sofar = 0;
+			double limit = all * kinv(k(0) + 1);
+			for (size_t i = 1; i < points.size(); ++i) {
+				const Centroid &next = points[i];
+				if (sofar + cur.weight + next.weight <= limit) {
+					cur.weight += next.weight;
+					cur.mean += (next.mean - cur.mean) * next.weight / cur.weight;
+				}
+				else {
+					sofar += cur.weight;
+					out.push_back(cur);
+					limit = all * kinv(k(sofar / all) + 1);
+					cur = next;
+				}
+			}
+			out.push_back(cur);
+			return all;
+		}
+
+		/**
+		 * Merges buffered points with centroids
+		 */
+		void compress() {
+			if (buffer.empty()) return;
+			buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+			total = merge(buffer, centroids);
+			buffer.clear();
+		}
+
+		/**
+		 * Centroids with buffered points merged, without modifying this
+		 *
+		 * @param tmp holds the merged copy if points are buffered
+		 * @param all total weight
+		 * @return centroids, or tmp
+		 */
+		const std::vector<Centroid> &merged(std::vector<Centroid> &tmp, double &all) const {
+			all = total;
+			if (buffer.empty()) return centroids;
+			std::vector<Centroid> points(buffer);
+			points.insert(points.end(), centroids.begin(), centroids.end());
+			all = merge(points, tmp);
+			return tmp;
+		}
+
+	public:
+		/**
+		 * @param compression bounds the number of centroids (~compression/2..compression),
+		 *                    larger values are more accurate
+		 * @throws invalid_argument if compression is not > 0
+		 */
+		explicit TDigest(double compression = 100) : compression(compression) {
+			if (!(compression > 0)) throw std::invalid_argument("TDigest: compression must be > 0");
+			bufferSize = std::max<size_t>(1, static_cast<size_t>(5 * compression));
+			buffer.reserve(bufferSize + static_cast<size_t>(compression));
+		}
+
+		/**
+		 * @param x      value to add
+		 * @param weight number of times x is added
+		 */
+		void add(double x, double weight = 1) {
+			if (std::isnan(x)) return;
+			minValue = std::min(minValue, x);
+			maxValue = std::max(maxValue, x);
+			buffer.push_back({x, weight});
+			if (buffer.size() >= bufferSize) compress();
+		}
+
+		/**
+		 * Merges buffered points: next queries do not copy centroids
+		 */
+		void flush() { compress(); }
+
+		/**
+		 * Adds all centroids of other digest to this, other may be this
+		 */
+		void merge(const TDigest &other) {
+			std::vector<Centroid> tmp;
+			double all;
+			//a copy: merging changes the centroids of this
+			const std::vector<Centroid> points = other.merged(tmp, all);
+			for (auto &c : points) {
+				buffer.push_back(c);
+				if (buffer.size() >= bufferSize) compress();
+			}
+			minValue = std::min(minValue, other.minValue);
+			maxValue = std::max(maxValue, other.maxValue);
+		}
+
+		/**
+		 * @return total weight added
+		 */
+		double count() const {
+			double all = total;
+			for (auto &c : buffer) all += c.weight;
+			return all;
+		}
+
+		/**
+		 * @return number of centroids after merging buffer
+		 */
+		size_t size() const {
+			std::vector<Centroid> tmp;
+			double all;
+			return merged(tmp, all).size();
+		}
+
+		/**
+		 * Linear interpolation between centroid centers,
+		 * min and max are the ends of the distribution
+		 *
+		 * @param q quantile in [0, 1]
+		 * @return estimated value at quantile q, NaN if empty
+		 */
+		double quantile(double q) const {
+			std::vector<Centroid> tmp;
+			double all;
+			const std::vector<Centroid> &sorted = merged(tmp, all);
+			if (sorted.empty()) return std::numeric_limits<double>::quiet_NaN();
+			if (q <= 0) return minValue;
+			if (q >= 1) return maxValue;
+
+			const double index = q * all;
+			double prevPos = 0;
+			double prevMean = minValue;
+			double cum = 0;
+			for (auto &c : sorted) {
+				const double pos = cum + c.weight / 2;
+				//single points are exact
+				if (c.weight == 1 && index >= cum && index < cum + 1) return c.mean;
+				if (index < pos) {
+					const double t = (pos == prevPos) ? 0 : (index - prevPos) / (pos - prevPos);
+					return prevMean + t * (c.mean - prevMean);
+				}
+				cum += c.weight;
+				prevPos = pos;
+				prevMean = c.mean;
+			}
+			const double t = (all == prevPos) ? 1 : (index - prevPos) / (all - prevPos);
+			return prevMean + t * (maxValue - prevMean);
+		}
+	};
+
+} //end namespace had
+
+#endif //__HAD_TDIGEST_HPP__
@@ -0,0 +1,85 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+#include <random>
+#include <catch2/catch.hpp>
+#include "convolution.hpp"
+#include "slidingwindow.hpp"
+
+#define DTYPE double
+
+using namespace had;
+
+//Naive O(n.k) reference
+static evector<DTYPE> naive(const evector<DTYPE> &v, const evector<DTYPE> &h, Border border) {
+	const int k = h.size();
+	evector<DTYPE> e = extended(v, (k - 1) / 2, k - 1 - (k - 1) / 2, border);
+	evector<DTYPE> ret;
+	for (int i = 0; i + k <= (int) e.size(); ++i) {
+		double s = 0;
+		for (int j = 0; j < k; ++j) s += h[j] * e[i + k - 1 - j];
+		ret.push_back(s);
+	}
+	return ret;
+}
+
+static void requireClose(const evector<DTYPE> &a, const evector<DTYPE> &b) {
+	REQUIRE(a.size() == b.size());
+	for (size_t i = 0; i < a.size(); ++i)
+		REQUIRE(a[i] == Approx(b[i]).margin(1e-8));
+}
+
+TEST_CASE( "Convolution", "[Convolution]" ) {
+	typedef Convolution<DTYPE> Conv;
+	had::evector<DTYPE> v5 = {1.1, 2.2, 3.3, 4.4, 5.5};
+
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<DTYPE> dist(-1, 1);
+	had::evector<DTYPE> vr(3000);
+	for (auto &x : vr) x = dist(gen);
+
+	SECTION("FFT") {
+		for (size_t n : {2, 4, 32, 1024}) {
+			std::vector<double> x(n), y(n);
+			std::vector<FFT::cpx> X(n / 2 + 1);
+			for (auto &s : x) s = dist(gen);
+			FFT::forward(x.data(), X.data(), n);
+
+			FFT::cpx dc = 0;
+			for (auto s : x) dc += s;
+			REQUIRE(X[0].real() == Approx(dc.real()));
+
+			FFT::inverse(X.data(), y.data(), n);
+			for (size_t i = 0; i < n; ++i) REQUIRE(y[i] == Approx(x[i]).margin(1e-12));
+		}
+		REQUIRE_THROWS_AS(FFT::plan(12), std::invalid_argument);
+	}
+
+	SECTION("Small") {
+		REQUIRE(to_string(Conv::convolve(v5, {1, 2}, Border::valid)) == "[ 4.4 7.7 11 14.3 ]");
+		REQUIRE(to_string(Conv::correlate(v5, {1, 2}, Border::valid)) == "[ 5.5 8.8 12.1 15.4 ]");
+		REQUIRE(to_string(Conv::correlate(v5, {1, 2}, Border::valid, Conv::Method::fft)) == "[ 5.5 8.8 12.1 15.4 ]");
+		REQUIRE(Conv::convolve(v5, {1, 2, 3, 4, 5, 6}, Border::valid).empty());
+		REQUIRE_THROWS_AS(Conv::convolve(v5, {}), std::invalid_argument);
+	}
+
+	SECTION("Against naive") {
+		for (Border border : {Border::valid, Border::symmetric})
+			for (int k : {1, 2, 5, 64, 65, 300}) {
+				had::evector<DTYPE> h(k);
+				for (auto &x : h) x = dist(gen);
+				evector<DTYPE> ref = naive(vr, h, border);
+				requireClose(Conv::convolve(vr, h, border, Conv::Method::direct), ref);
+				requireClose(Conv::convolve(vr, h, border, Conv::Method::fft), ref);
+				requireClose(Conv::convolve(vr, h, border), ref);
+
+				evector<DTYPE> hr(h.rbegin(), h.rend());
+				requireClose(Conv::correlate(vr, hr, border), ref);
+			}
+	}
+
+	SECTION("Moving sum") {
+		evector<DTYPE> ones(101, 1.0);
+		requireClose(Conv::correlate(vr, ones), SlidingWindow<DTYPE>::sum(vr, 101));
+	}
+}
@@ -0,0 +1,126 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+#include <limits>
+#include <random>
+#include <sstream>
+#include <catch2/catch.hpp>
+#include "fixed.hpp"
+#include "stats.hpp"
+
+using namespace had;
+
+TEST_CASE( "Fixed point", "[fixed]" ) {
+	const Q15 one = Q15::fromRaw(INT16_MAX);
+	const Q15 minusOne = Q15::fromRaw(INT16_MIN);
+
+	SECTION("Scalar") {
+		REQUIRE(sizeof(Q15) == 2);
+		REQUIRE(sizeof(Q31) == 4);
+		REQUIRE(Q15(0.5).raw() == 16384);
+		REQUIRE(Q15(2.0) == one);
+		REQUIRE(Q15(-2.0) == minusOne);
+		REQUIRE(double(Q15(-0.25)) == -0.25);
+		REQUIRE(double(Q31(0.1)) == Approx(0.1).epsilon(1e-9));
+
+		//saturation
+		REQUIRE(one + one == one);
+		REQUIRE(minusOne - one == minusOne);
+		REQUIRE(minusOne * minusOne == one);
+		REQUIRE(-minusOne == one);
+		REQUIRE(Q15(0.5) * Q15(0.5) == Q15(0.25));
+		REQUIRE(Q15(0.5) + Q15(-0.75) == Q15(-0.25));
+		REQUIRE(Q15(0.25) < Q15(0.5));
+
+		typedef had::fixed<int16_t, 4> Q12_4;	//had:: since std::fixed is also visible
+		REQUIRE(double(Q12_4(3.5) * Q12_4(2.0)) == 7.0);
+		REQUIRE(double(Q12_4(5000.0)) == Approx(2047.9375));
+	}
+
+	SECTION("evector of fixed") {
+		had::evector<Q15> v = { Q15(0.5), Q15(-0.25), Q15(0.125), Q15(0.0) };
+		REQUIRE(v.avg() == 0.09375);
+		REQUIRE(to_string(v) == "[ 0.5 -0.25 0.125 0 ]");
+		std::stringstream out;
+		out << v;
+		REQUIRE(out.str() == "[ 0.5 -0.25 0.125 0 ]");
+
+		StreamStats s;
+		s.add(v);
+		REQUIRE(s.mean() == 0.09375);
+	}
+
+	SECTION("Kernels against scalar") {
+		std::mt19937 gen(0);
+		std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+		const size_t n = 1003;
+		had::evector<Q15> a(n), b(n);
+		for (size_t i = 0; i < n; ++i) {
+			a[i] = Q15::fromRaw(dist(gen));
+			b[i] = Q15::fromRaw(dist(gen));
+		}
+		//edge cases
+		a[0] = b[0] = minusOne;
+		a[1] = minusOne; b[1] = one;
+		a[2] = b[2] = one;
+
+		had::evector<Q15> sum = FixedVector::add(a, b);
+		had::evector<Q15> dif = FixedVector::sub(a, b);
+		had::evector<Q15> prd = FixedVector::mul(a, b);
+		for (size_t i = 0; i < n; ++i) {
+			REQUIRE(sum[i] == a[i] + b[i]);
+			REQUIRE(dif[i] == a[i] - b[i]);
+			REQUIRE(prd[i] == a[i] * b[i]);
+		}
+		REQUIRE_THROWS_AS(FixedVector::add(a, had::evector<Q15>(1)), std::length_error);
+
+		had::evector<Q31> a31(n), b31(n);
+		for (size_t i = 0; i < n; ++i) {
+			a31[i] = Q31(double(a[i]));
+			b31[i] = Q31(double(b[i]));
+		}
+		had::evector<Q31> prd31 = FixedVector::mul(a31, b31);
+		for (size_t i = 0; i < n; ++i)
+			REQUIRE(double(prd31[i]) == Approx(double(a[i]) * double(b[i])).margin(1e-9));
+	}
+
+	SECTION("Float conversion") {
+		had::evector<float> f = { 0.5f, -0.25f, 1.5f, -3.0f, 0.1f, 0.3f, -0.7f, 0.99f, 0.001f, -1.0f };
+		had::evector<Q15> q = FixedVector::toFixed<Q15>(f);
+		REQUIRE(q[2] == one);
+		REQUIRE(q[3] == minusOne);
+		for (size_t i = 0; i < f.size(); ++i)
+			REQUIRE(double(q[i]) == Approx(std::clamp(f[i], -1.0f, 1.0f)).margin(1.0 / 32768));
+
+		had::evector<float> back = FixedVector::toFloat<float>(q);
+		for (size_t i = 0; i < f.size(); ++i)
+			REQUIRE(back[i] == float(double(q[i])));
+
+		had::evector<double> d = FixedVector::toFloat<double>(q);
+		REQUIRE(d[0] == 0.5);
+	}
+
+	SECTION("Float conversion same in SIMD body and tail") {
+		//ties, NaN, near ties and saturation, at every index of blocks of 8 and the tail
+		const float lsb = 1.0f / 32768;
+		const float special[] = { std::numeric_limits<float>::quiet_NaN(), 2.5f * lsb, -2.5f * lsb, 0.5f * lsb,
+								  -0.5f * lsb, 1.5f * lsb, 0.49999997f * lsb, -1.5f * lsb, 32766.5f * lsb,
+								  -32767.5f * lsb, 2.0f, -2.0f, std::numeric_limits<float>::infinity(),
+								  -std::numeric_limits<float>::infinity(), 0.0f, -0.0f };
+		const size_t nspecial = sizeof(special) / sizeof(special[0]);
+		for (size_t n = 1; n <= 27; ++n)
+			for (size_t k = 0; k < nspecial; ++k) {
+				had::evector<float> f(n);
+				for (size_t i = 0; i < n; ++i) f[i] = special[(i + k) % nspecial];
+				had::evector<Q15> q = FixedVector::toFixed<Q15>(f);
+				for (size_t i = 0; i < n; ++i)
+					REQUIRE(q[i].raw() == Q15(double(f[i])).raw());
+			}
+
+		had::evector<float> f(9, 2.5f * lsb);
+		f[0] = std::numeric_limits<float>::quiet_NaN();
+		had::evector<Q15> q = FixedVector::toFixed<Q15>(f);
+		REQUIRE(q[0].raw() == 0);
+		for (size_t i = 1; i < 9; ++i) REQUIRE(q[i].raw() == 3);
+	}
+}
@@ -0,0 +1,91 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <catch2/catch.hpp>
+#include "slidingwindow.hpp"
+
+#define DTYPE double
+
+using namespace had;
+
+//Naive O(n.w) reference, window extended with symmExt() if needed
+template<typename F>
+static evector<DTYPE> naive(const evector<DTYPE> &v, int w, Border border, F f) {
+	evector<DTYPE> e = extended(v, (w - 1) / 2, w - 1 - (w - 1) / 2, border);
+	evector<DTYPE> ret;
+	for (int i = 0; i + w <= (int) e.size(); ++i) {
+		evector<DTYPE> win(e.begin() + i, e.begin() + i + w);
+		ret.push_back(f(win));
+	}
+	return ret;
+}
+
+static void requireClose(const evector<DTYPE> &a, const evector<DTYPE> &b) {
+	REQUIRE(a.size() == b.size());
+	for (size_t i = 0; i < a.size(); ++i)
+		REQUIRE(a[i] == Approx(b[i]).margin(1e-9));
+}
+
+TEST_CASE( "Sliding window filters", "[SlidingWindow]" ) {
+	had::evector<DTYPE> v5 = {1.1, 2.2, 3.3, 4.4, 5.5};
+
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> dist(-50, 50);
+	had::evector<DTYPE> vr(1000);
+	for (auto &x : vr) x = dist(gen);
+
+	auto sum = [](evector<DTYPE> &w) { return std::accumulate(w.begin(), w.end(), 0.0); };
+	auto mean = [](evector<DTYPE> &w) { return w.avg(); };
+	auto var = [](evector<DTYPE> &w) {
+		double m = w.avg(), s = 0;
+		for (auto x : w) s += (x - m) * (x - m);
+		return s / w.size();
+	};
+	auto min = [](evector<DTYPE> &w) { return *std::min_element(w.begin(), w.end()); };
+	auto max = [](evector<DTYPE> &w) { return *std::max_element(w.begin(), w.end()); };
+	auto median = [](evector<DTYPE> &w) {
+		std::sort(w.begin(), w.end());
+		return w[std::lround(0.5 * (w.size() - 1))];
+	};
+	auto p90 = [](evector<DTYPE> &w) {
+		std::sort(w.begin(), w.end());
+		return w[std::lround(0.9 * (w.size() - 1))];
+	};
+
+	SECTION("Small") {
+		REQUIRE(to_string(SlidingWindow<DTYPE>::sum(v5, 3, Border::valid)) == "[ 6.6 9.9 13.2 ]");
+		REQUIRE(to_string(SlidingWindow<DTYPE>::min(v5, 3)) == "[ 1.1 1.1 2.2 3.3 4.4 ]");
+		REQUIRE(to_string(SlidingWindow<DTYPE>::max(v5, 3)) == "[ 2.2 3.3 4.4 5.5 5.5 ]");
+		REQUIRE(to_string(SlidingWindow<DTYPE>::median(v5, 3)) == "[ 1.1 2.2 3.3 4.4 5.5 ]");
+		REQUIRE(SlidingWindow<DTYPE>::mean(v5, 9, Border::valid).empty());
+
+		//window larger than signal, extends like symmExt()
+		requireClose(SlidingWindow<DTYPE>::max(v5, 13), naive(v5, 13, Border::symmetric, max));
+
+		had::evector<DTYPE> v0 = {};
+		REQUIRE_THROWS_AS(SlidingWindow<DTYPE>::sum(v0, 3), std::length_error);
+		REQUIRE_THROWS_AS(SlidingWindow<DTYPE>::sum(v5, 0), std::invalid_argument);
+		REQUIRE_THROWS_AS(SlidingWindow<DTYPE>::percentile(v5, 3, 1.5), std::invalid_argument);
+		evector<DTYPE> withNaN = v5;
+		withNaN[2] = std::numeric_limits<DTYPE>::quiet_NaN();
+		REQUIRE_THROWS_AS(SlidingWindow<DTYPE>::median(withNaN, 3), std::invalid_argument);
+		REQUIRE_THROWS_AS(SlidingWindow<DTYPE>::percentile(withNaN, 3, 0.9, Border::valid), std::invalid_argument);
+	}
+
+	SECTION("Against naive") {
+		for (Border border : {Border::valid, Border::symmetric})
+			for (int w : {1, 2, 7, 31, 32})
+				for (int threads : {1, 4}) {
+					requireClose(SlidingWindow<DTYPE>::sum(vr, w, border, threads), naive(vr, w, border, sum));
+					requireClose(SlidingWindow<DTYPE>::mean(vr, w, border, threads), naive(vr, w, border, mean));
+					requireClose(SlidingWindow<DTYPE>::variance(vr, w, border, threads), naive(vr, w, border, var));
+					requireClose(SlidingWindow<DTYPE>::min(vr, w, border, threads), naive(vr, w, border, min));
+					requireClose(SlidingWindow<DTYPE>::max(vr, w, border, threads), naive(vr, w, border, max));
+					requireClose(SlidingWindow<DTYPE>::median(vr, w, border, threads), naive(vr, w, border, median));
+					requireClose(SlidingWindow<DTYPE>::percentile(vr, w, 0.9, border, threads), naive(vr, w, border, p90));
+				}
+	}
+}
@@ -0,0 +1,80 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+#include <sstream>
+#include <catch2/catch.hpp>
+#include <appTest/AllocCounter.hpp>
+#include "small_evector.hpp"
+
+#define DTYPE double
+
+using namespace had;
+
+TEST_CASE( "Small evector", "[small_evector]" ) {
+	typedef small_evector<DTYPE, 8> svector;
+	had::evector<DTYPE> v5 = {1.1, 2.2, 3.3, 4.4, 5.5};
+	std::string v5str = "[ 1.1 2.2 3.3 4.4 5.5 ]";
+
+	SECTION("Inline") {
+		size_t before = allocations;
+		svector s = {1.1, 2.2, 3.3, 4.4, 5.5};
+		svector c = s;
+		c.push_back(6.6);
+		REQUIRE(s.isInline());
+		REQUIRE(c.size() == 6);
+		REQUIRE(c.back() == 6.6);
+		REQUIRE(s.avg() == Approx(v5.avg()));
+		REQUIRE(allocations == before);
+
+		REQUIRE(to_string(s) == v5str);
+		REQUIRE(to_string(s, '\n', -1, 1) == "[\n1.1\n2.2\n3.3\n4.4\n5.5\n]");
+		std::stringstream out;
+		out << s;
+		REQUIRE(out.str() == v5str);
+		REQUIRE_THROWS_AS(s.at(5), std::out_of_range);
+	}
+
+	SECTION("Spill to heap") {
+		svector s;
+		for (int i = 0; i < 100; ++i) s.emplace_back(i);
+		REQUIRE(!s.isInline());
+		REQUIRE(s.size() == 100);
+		REQUIRE(s[99] == 99);
+
+		svector m = std::move(s);
+		REQUIRE(m.size() == 100);
+		REQUIRE(s.empty());
+		REQUIRE(s.isInline());
+
+		m.resize(3);
+		svector i = m;
+		REQUIRE(i.isInline());
+		REQUIRE(to_string(i) == "[ 0 1 2 ]");
+	}
+
+	SECTION("evector interoperability") {
+		svector s = v5;
+		REQUIRE(s == v5);
+		had::evector<DTYPE> e = s;
+		REQUIRE(e == v5);
+	}
+
+	SECTION("Symmetric extension as evector") {
+		const had::evector<DTYPE> v0 = {};
+		const had::evector<DTYPE> v1 = {1.1};
+		const had::evector<DTYPE> v2 = {1.1, 2.2};
+		int cases[][2] = { {3, 3}, {2, 3}, {2, 2}, {0, 0}, {5, 5}, {13, 1} };
+
+		for (auto &v : { v1, v2, v5 })
+			for (auto &c : cases) {
+				had::evector<DTYPE> e = v;
+				svector s = v;
+				e.symmExt(c[0], c[1]);
+				s.symmExt(c[0], c[1]);
+				REQUIRE(to_string(s) == to_string(e));
+			}
+
+		svector s0 = v0;
+		REQUIRE_THROWS_AS(s0.symmExt(1, 1), std::length_error);
+	}
+}
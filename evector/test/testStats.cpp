@@ -0,0 +1,130 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+#include <algorithm>
+#include <random>
+#include <catch2/catch.hpp>
+#include "stats.hpp"
+
+#define DTYPE double
+
+using namespace had;
+
+TEST_CASE( "Streaming statistics", "[StreamStats]" ) {
+	std::mt19937 gen(0);
+	std::exponential_distribution<DTYPE> dist(2.0);
+	had::evector<DTYPE> v(10000);
+	for (auto &x : v) x = dist(gen);
+
+	//Two pass reference
+	const double n = v.size();
+	const double mean = v.avg();
+	double m2 = 0, m3 = 0, m4 = 0;
+	for (auto x : v) {
+		const double d = x - mean;
+		m2 += d * d;
+		m3 += d * d * d;
+		m4 += d * d * d * d;
+	}
+	const double var = m2 / n;
+	const double skew = std::sqrt(n) * m3 / std::pow(m2, 1.5);
+	const double kurt = n * m4 / (m2 * m2) - 3;
+
+	auto check = [&](const StreamStats &s) {
+		REQUIRE(s.count() == v.size());
+		REQUIRE(s.mean() == Approx(mean));
+		REQUIRE(s.variance() == Approx(var));
+		REQUIRE(s.sampleVariance() == Approx(m2 / (n - 1)));
+		REQUIRE(s.skewness() == Approx(skew));
+		REQUIRE(s.kurtosis() == Approx(kurt));
+		REQUIRE(s.min() == *std::min_element(v.begin(), v.end()));
+		REQUIRE(s.max() == *std::max_element(v.begin(), v.end()));
+	};
+
+	SECTION("Samples") {
+		StreamStats s;
+		for (auto x : v) s.add(x);
+		check(s);
+	}
+
+	SECTION("Chunks") {
+		StreamStats s;
+		for (size_t b = 0; b < v.size(); b += 999)
+			s.add(had::evector<DTYPE>(v.begin() + b, v.begin() + std::min(v.size(), b + 999)));
+		check(s);
+	}
+
+	SECTION("Merge shards") {
+		StreamStats a, b, c, empty;
+		for (size_t i = 0; i < v.size(); ++i)
+			(i < 100 ? a : i < 7000 ? b : c).add(v[i]);
+		a.merge(empty);
+		empty.merge(a);
+		a += b;
+		a += c;
+		check(a);
+		REQUIRE(empty.count() == 100);
+	}
+
+	SECTION("Quantiles") {
+		StreamStats a(200), b(200);
+		for (size_t i = 0; i < v.size(); ++i)
+			(i % 2 ? a : b).add(v[i]);
+		a.merge(b);
+
+		had::evector<DTYPE> sorted = v;
+		std::sort(sorted.begin(), sorted.end());
+		for (double q : {0.01, 0.1, 0.5, 0.9, 0.99})
+			REQUIRE(a.quantile(q) == Approx(sorted[q * n]).epsilon(0.02));
+		REQUIRE(a.quantile(0) == sorted.front());
+		REQUIRE(a.quantile(1) == sorted.back());
+
+		StreamStats s;
+		REQUIRE_THROWS_AS(s.quantile(0.5), std::logic_error);
+	}
+
+	SECTION("Const quantiles do not merge buffer") {
+		TDigest d(100);
+		for (int i = 0; i < 1234; ++i) d.add(i % 97);
+		const TDigest &c = d;
+		const double median = c.quantile(0.5);
+		const size_t size = c.size();
+		REQUIRE(c.count() == 1234);
+
+		//merging a copy gives the same as merging in place
+		TDigest other(100);
+		other.merge(c);
+		d.flush();
+		REQUIRE(c.quantile(0.5) == median);
+		REQUIRE(c.size() == size);
+		REQUIRE(c.count() == 1234);
+		REQUIRE(other.count() == 1234);
+		REQUIRE(other.quantile(0.5) == Approx(median).epsilon(0.02));
+	}
+
+	SECTION("Self merge") {
+		TDigest d(100);
+		for (int i = 0; i < 1000; ++i) d.add(i);
+		d.flush();
+		d.merge(d);
+		REQUIRE(d.count() == 2000);
+		REQUIRE(d.quantile(0.5) == Approx(500).epsilon(0.02));
+
+		StreamStats s(100);
+		for (double x : v) s.add(x);
+		const double median = s.quantile(0.5);
+		s += s;
+		REQUIRE(s.count() == 2 * v.size());
+		REQUIRE(s.quantile(0.5) == Approx(median).epsilon(0.02));
+	}
+
+	SECTION("Invalid compression") {
+		REQUIRE_THROWS_AS(TDigest(0), std::invalid_argument);
+		REQUIRE_THROWS_AS(TDigest(-1), std::invalid_argument);
+		REQUIRE_THROWS_AS(TDigest(std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+		REQUIRE_THROWS_AS(StreamStats(0), std::invalid_argument);
+		TDigest tiny(0.1);
+		for (int i = 0; i < 10; ++i) tiny.add(i);
+		REQUIRE(tiny.count() == 10);
+	}
+}
@@ -8,6 +8,8 @@
 #ifndef __HAD_FILE_HPP__
 #define __HAD_FILE_HPP__
 
+#include <array>
+#include <cstring>
 #include <fstream>
 #include <istream>
 #include <regex>
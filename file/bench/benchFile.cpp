@@ -0,0 +1,37 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// File benchmarks
+//
+#include <cstdio>
+#include <stopwatch/benchmark.hpp>
+#include <string/String.hpp>
+#include "File.hpp"
+
+using namespace had;
+
+int main(int argc, char **argv) {
+	const string fn0 = "benchFile0.tmp";
+	const string fn1 = "benchFile1.tmp";
+
+	const int ret = Benchmark::main(argc, argv, [&](Benchmark &bench) {
+		const size_t n = 16 << 20;
+		const string data = String::rand(n);
+		File::write(fn0, data);
+		File::write(fn1, data);
+
+		bench.run("File::cmpbin 16MB equal", [&] {
+			bool eq = File::cmpbin(fn0, fn1);
+			doNotOptimize(eq);
+		}, n);
+
+		bench.run("File::read 16MB", [&] {
+			string s = File::read(fn0);
+			doNotOptimize(s.data());
+		}, n);
+	});
+
+	std::remove(fn0.c_str());
+	std::remove(fn1.c_str());
+	return ret;
+}
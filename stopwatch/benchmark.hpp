@@ -0,0 +1,346 @@
+/**
+ * Microbenchmark harness built on StopWatch
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * Each benchmark is:
+ *   - warmed up for a while
+ *   - calibrated: number of iterations per repetition grows until one
+ *     repetition takes at least minTime
+ *   - repeated, each repetition is a sample of time per iteration
+ *   - samples further than outlierMads scaled MADs from the median are rejected
+ *
+ * Use it as:
+ *     Benchmark bench;
+ *     bench.run("symmExt", [&] {
+ *         evector<double> e = v;
+ *         e.symmExt(3, 3);
+ *         doNotOptimize(e);
+ *     }, v.size() * sizeof(double));
+ *     cout << bench;
+ *     bench.writeJSON(file);
+ *
+ * doNotOptimize() and clobberMemory() are compiler barriers, so benchmarked
+ * code whose results are not used is not removed by the optimizer.
+ */
+
+#ifndef __HAD_BENCHMARK_HPP__
+#define __HAD_BENCHMARK_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "stopwatch.hpp"
+#include "tscclock.hpp"
+
+using std::ostream;
+using std::string;
+using std::vector;
+
+namespace had {
+
+	/**
+	 * Makes the compiler assume value is read, so it is computed
+	 */
+	template<class T>
+	inline void doNotOptimize(const T &value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	/**
+	 * Makes the compiler assume value is read and written
+	 */
+	template<class T>
+	inline void doNotOptimize(T &value) {
+		//GCC rejects "+r,m" when optimizing: small trivial values in a register, others in memory
+		if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+			asm volatile("" : "+r"(value) : : "memory");
+		else
+			asm volatile("" : "+m"(value) : : "memory");
+	}
+
+	/**
+	 * Makes the compiler assume all memory is read and written,
+	 * so pending writes are done
+	 */
+	inline void clobberMemory() {
+		asm volatile("" : : : "memory");
+	}
+
+
+	class Benchmark {
+	public:
+		struct Options {
+			double warmup = 0.05;          //seconds running before measuring
+			double minTime = 0.05;         //minimum seconds per repetition
+			int repetitions = 15;          //at least 1
+			double outlierMads = 3.0;      //rejection threshold, in scaled MADs
+
+			/**
+			 * @throws invalid_argument if minTime is not > 0 or repetitions < 1
+			 */
+			void check() const {
+				if (!(minTime > 0)) throw std::invalid_argument("Benchmark: minTime must be > 0");
+				if (repetitions < 1) throw std::invalid_argument("Benchmark: repetitions must be >= 1");
+			}
+		};
+
+		struct Result {
+			string name;
+			uint64_t iterations;           //per repetition
+			vector<double> samples;        //ns per iteration of each kept repetition
+			size_t rejected;               //number of outlier repetitions
+			double median, mad, mean, stddev, min, max;
+			double bytesPerSecond;         //0 if bytes per iteration not given
+			double itemsPerSecond;         //0 if items per iteration not given
+		};
+
+		/**
+		 * @return median of v
+		 */
+		static double median(vector<double> v) {
+			if (v.empty()) return 0;
+			const size_t m = v.size() / 2;
+			std::nth_element(v.begin(), v.begin() + m, v.end());
+			if (v.size() % 2) return v[m];
+			const double hi = v[m];
+			return (*std::max_element(v.begin(), v.begin() + m) + hi) / 2;
+		}
+
+		/**
+		 * @return median absolute deviation of v, scaled to be comparable with stddev
+		 */
+		static double mad(const vector<double> &v, double med) {
+			vector<double> dev(v.size());
+			for (size_t i = 0; i < v.size(); ++i) dev[i] = std::fabs(v[i] - med);
+			return 1.4826 * median(dev);
+		}
+
+	private:
+		Options opt;
+		vector<Result> all;
+
+		template<typename F>
+		static double timeIterations(F &f, uint64_t iterations) {
+			TscStopWatch sw;
+			for (uint64_t i = 0; i < iterations; ++i) {
+				f();
+				clobberMemory();
+			}
+			sw.lap();
+			return sw.watch();
+		}
+
+		//escapes string for JSON: quote, backslash and control characters
+		static string jsonQuoted(const string &s) {
+			static constexpr char hex[] = "0123456789abcdef";
+			string ret = "\"";
+			for (char c : s) {
+				const unsigned char u = c;
+				if (c == '"' || c == '\\') (ret += '\\') += c;
+				else if (c == '\n') ret += "\\n";
+				else if (c == '\t') ret += "\\t";
+				else if (c == '\r') ret += "\\r";
+				else if (u < 0x20) (ret += "\\u00") += { hex[u >> 4], hex[u & 0xF] };
+				else ret += c;
+			}
+			return ret + "\"";
+		}
+
+		//RFC 4180: quotes are doubled
+		static string csvQuoted(const string &s) {
+			string ret = "\"";
+			for (char c : s) {
+				if (c == '"') ret += '"';
+				ret += c;
+			}
+			return ret + "\"";
+		}
+
+		//restores format of a stream when leaving scope
+		class StreamFormat {
+			ostream &os;
+			std::ios::fmtflags flags;
+			std::streamsize precision;
+
+		public:
+			explicit StreamFormat(ostream &os) : os(os), flags(os.flags()), precision(os.precision()) { }
+			~StreamFormat() {
+				os.flags(flags);
+				os.precision(precision);
+			}
+		};
+
+	public:
+		Benchmark() = default;
+
+		/**
+		 * @throws invalid_argument if options are invalid, see Options::check()
+		 */
+		explicit Benchmark(const Options &opt) : opt(opt) { opt.check(); }
+
+		/**
+		 * @param name           benchmark name
+		 * @param f              code to benchmark, called once per iteration
+		 * @param bytesPerIter   bytes processed per iteration, for throughput
+		 * @param itemsPerIter   items processed per iteration, for throughput
+		 * @return benchmark result, also kept for reporting
+		 */
+		template<typename F>
+		const Result &run(const string &name, F f, uint64_t bytesPerIter = 0, uint64_t itemsPerIter = 0) {
+			//warmup
+			StopWatch sw;
+			do {
+				f();
+				sw.lap();
+			} while (sw.watch() < opt.warmup);
+
+			//calibrate iterations to last at least minTime
+			uint64_t iterations = 1;
+			for (;;) {
+				const double t = timeIterations(f, iterations);
+				if (t >= opt.minTime) break;
+				const double scale = t > 0 ? opt.minTime / t * 1.2 : 10;
+				iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+			}
+
+			Result r;
+			r.name = name;
+			r.iterations = iterations;
+			vector<double> raw;
+			for (int rep = 0; rep < opt.repetitions; ++rep)
+				raw.push_back(timeIterations(f, iterations) * 1e9 / iterations);
+
+			//outlier rejection around median
+			const double med = median(raw);
+			const double dev = mad(raw, med);
+			for (double s : raw)
+				if (dev == 0 || std::fabs(s - med) <= opt.outlierMads * dev) r.samples.push_back(s);
+			r.rejected = raw.size() - r.samples.size();
+
+			r.median = median(r.samples);
+			r.mad = mad(r.samples, r.median);
+			r.min = *std::min_element(r.samples.begin(), r.samples.end());
+			r.max = *std::max_element(r.samples.begin(), r.samples.end());
+			double sum = 0, sumsq = 0;
+			for (double s : r.samples) {
+				sum += s;
+				sumsq += s * s;
+			}
+			r.mean = sum / r.samples.size();
+			r.stddev = std::sqrt(std::max(sumsq / r.samples.size() - r.mean * r.mean, 0.0));
+			r.bytesPerSecond = r.median > 0 ? bytesPerIter / (r.median * 1e-9) : 0;
+			r.itemsPerSecond = r.median > 0 ? itemsPerIter / (r.median * 1e-9) : 0;
+
+			all.push_back(r);
+			return all.back();
+		}
+
+		/**
+		 * @return results of all benchmarks run
+		 */
+		const vector<Result> &results() const { return all; }
+
+		void writeJSON(ostream &os) const {
+			StreamFormat format(os);
+			os << std::setprecision(10) << "[\n";
+			for (size_t i = 0; i < all.size(); ++i) {
+				const Result &r = all[i];
+				os << "  {\"name\": " << jsonQuoted(r.name)
+				   << ", \"iterations\": " << r.iterations
+				   << ", \"median_ns\": " << r.median << ", \"mad_ns\": " << r.mad
+				   << ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": " << r.stddev
+				   << ", \"min_ns\": " << r.min << ", \"max_ns\": " << r.max
+				   << ", \"rejected\": " << r.rejected
+				   << ", \"bytes_per_second\": " << r.bytesPerSecond
+				   << ", \"items_per_second\": " << r.itemsPerSecond
+				   << ", \"samples_ns\": [";
+				for (size_t s = 0; s < r.samples.size(); ++s)
+					os << (s ? ", " : "") << r.samples[s];
+				os << "]}" << (i + 1 < all.size() ? "," : "") << "\n";
+			}
+			os << "]\n";
+		}
+
+		void writeCSV(ostream &os) const {
+			StreamFormat format(os);
+			os << std::setprecision(10)
+			   << "name,iterations,median_ns,mad_ns,mean_ns,stddev_ns,min_ns,max_ns,rejected,bytes_per_second,items_per_second\n";
+			for (const Result &r : all)
+				os << csvQuoted(r.name) << "," << r.iterations << "," << r.median << "," << r.mad << ","
+				   << r.mean << "," << r.stddev << "," << r.min << "," << r.max << "," << r.rejected << ","
+				   << r.bytesPerSecond << "," << r.itemsPerSecond << "\n";
+		}
+
+		/**
+		 * Runs benchmarks with command line options, for bench* executables:
+		 *   --json=<file>  --csv=<file>  --min-time=<seconds>  --reps=<n>
+		 *
+		 * @param benchmarks function that runs all benchmarks on the Benchmark received
+		 * @return process exit code
+		 */
+		template<typename F>
+		static int main(int argc, char **argv, F benchmarks) {
+			Options opt;
+			string json, csv;
+			auto usage = [argv] {
+				std::cerr << "Usage: " << argv[0] << " [--json=<file>] [--csv=<file>] [--min-time=<s > 0>] [--reps=<n >= 1>]\n";
+				return 1;
+			};
+			try {
+				for (int i = 1; i < argc; ++i) {
+					const string arg = argv[i];
+					auto value = [&arg](const string &key) { return arg.substr(key.size()); };
+					if (arg.rfind("--json=", 0) == 0) json = value("--json=");
+					else if (arg.rfind("--csv=", 0) == 0) csv = value("--csv=");
+					else if (arg.rfind("--min-time=", 0) == 0) opt.minTime = std::stod(value("--min-time="));
+					else if (arg.rfind("--reps=", 0) == 0) opt.repetitions = std::stoi(value("--reps="));
+					else return usage();
+				}
+				opt.check();
+			}
+			catch (const std::logic_error &) {     //invalid_argument and out_of_range of values
+				return usage();
+			}
+
+			Benchmark bench(opt);
+			benchmarks(bench);
+			std::cout << bench;
+			if (!json.empty()) {
+				std::ofstream f(json);
+				bench.writeJSON(f);
+			}
+			if (!csv.empty()) {
+				std::ofstream f(csv);
+				bench.writeCSV(f);
+			}
+			return 0;
+		}
+
+		/**
+		 * Prints a table of results
+		 */
+		friend ostream &operator<<(ostream &os, const Benchmark &b) {
+			StreamFormat format(os);
+			os << std::left << std::setw(40) << "benchmark" << std::right
+			   << std::setw(14) << "median ns" << std::setw(12) << "mad ns"
+			   << std::setw(12) << "iters" << std::setw(14) << "MB/s" << std::setw(14) << "Mitems/s" << "\n";
+			for (const Result &r : b.all) {
+				os << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(1)
+				   << std::setw(14) << r.median << std::setw(12) << r.mad
+				   << std::setw(12) << r.iterations
+				   << std::setw(14) << r.bytesPerSecond / 1e6 << std::setw(14) << r.itemsPerSecond / 1e6 << "\n";
+			}
+			return os;
+		}
+	};
+
+}
+
+#endif //__HAD_BENCHMARK_HPP__
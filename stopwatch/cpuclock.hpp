@@ -0,0 +1,154 @@
+/**
+ * CPU time clocks for StopWatch
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * ThreadCpuClock:  CPU time of calling thread, CLOCK_THREAD_CPUTIME_ID
+ * ProcessCpuClock: CPU time of all threads of process, CLOCK_PROCESS_CPUTIME_ID
+ *     Both can be used as BasicStopWatch<ThreadCpuClock>, etc.
+ *     Note: laps must be read on the same thread that did reset()
+ *
+ * CpuStopWatch reads wall, thread CPU, process CPU and thread user/sys
+ * time (getrusage(RUSAGE_THREAD)) on each reset() and lap(), so a section
+ * can be told CPU bound (thread ~ wall), I/O or lock bound (thread << wall)
+ * or parallel (process > wall).
+ */
+
+#ifndef __HAD_CPUCLOCK_HPP__
+#define __HAD_CPUCLOCK_HPP__
+
+#include <cstdint>
+#include <iostream>
+#include <sys/resource.h>
+#include <time.h>
+#include "stopwatch.hpp"
+
+using std::ostream;
+
+namespace had {
+
+	template<clockid_t id>
+	struct PosixClock {
+		typedef int64_t ticks;  //nanoseconds
+
+		static ticks now() {
+			timespec ts;
+			clock_gettime(id, &ts);
+			return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+		}
+
+		static double toSeconds(ticks t) { return t * 1e-9; }
+	};
+
+	typedef PosixClock<CLOCK_THREAD_CPUTIME_ID> ThreadCpuClock;
+	typedef PosixClock<CLOCK_PROCESS_CPUTIME_ID> ProcessCpuClock;
+
+
+	/**
+	 * Times of one lap, in seconds
+	 */
+	struct CpuTimes {
+		double wall;
+		double thread;       //CPU time of thread
+		double process;      //CPU time of all process threads
+		double user;         //thread CPU time in user mode
+		double sys;          //thread CPU time in kernel mode
+	};
+
+
+	template<class Clock>
+	class BasicCpuStopWatch {
+		struct Sample {
+			typename Clock::ticks wall;
+			ThreadCpuClock::ticks thread;
+			ProcessCpuClock::ticks process;
+			int64_t user, sys;  //microseconds
+		};
+		Sample start, stop;
+
+		static int64_t micros(const timeval &tv) {
+			return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+		}
+
+		static void read(Sample &s) {
+			rusage ru;
+#ifdef RUSAGE_THREAD
+			getrusage(RUSAGE_THREAD, &ru);
+#else
+			getrusage(RUSAGE_SELF, &ru);
+#endif
+			s.user = micros(ru.ru_utime);
+			s.sys = micros(ru.ru_stime);
+			s.process = ProcessCpuClock::now();
+			s.thread = ThreadCpuClock::now();
+			s.wall = Clock::now();
+		}
+
+	public:
+		/**
+		 * Creates StopWatch object and resets timers
+		 */
+		BasicCpuStopWatch() { reset(); }
+
+		/**
+		 * sets start and stop times equals to current times
+		 */
+		BasicCpuStopWatch &reset() {
+			read(start);
+			stop = start;
+			return *this; //for method chain
+		}
+
+		/**
+		 * sets stop times equals to current times
+		 */
+		BasicCpuStopWatch &lap() {
+			read(stop);
+			return *this; //for method chain
+		}
+
+		/**
+		 * @return real time elapsed since last reset() until last lap()
+		 */
+		double watch() const { return Clock::toSeconds(stop.wall - start.wall); }
+
+		/**
+		 * @return CPU time of calling thread since last reset() until last lap()
+		 */
+		double threadTime() const { return ThreadCpuClock::toSeconds(stop.thread - start.thread); }
+
+		/**
+		 * @return CPU time of all threads since last reset() until last lap()
+		 */
+		double processTime() const { return ProcessCpuClock::toSeconds(stop.process - start.process); }
+
+		/**
+		 * @return thread CPU time in user mode (microsecond resolution)
+		 */
+		double userTime() const { return (stop.user - start.user) * 1e-6; }
+
+		/**
+		 * @return thread CPU time in kernel mode (microsecond resolution)
+		 */
+		double sysTime() const { return (stop.sys - start.sys) * 1e-6; }
+
+		/**
+		 * @return all times of last lap
+		 */
+		CpuTimes times() const { return { watch(), threadTime(), processTime(), userTime(), sysTime() }; }
+	};
+
+	typedef BasicCpuStopWatch<ChronoClock> CpuStopWatch;
+
+	/**
+	 * Prints: "wall (thread CPU, process CPU, user, sys)" in seconds
+	 */
+	template<class Clock>
+	ostream &operator<<(ostream &os, const BasicCpuStopWatch<Clock> &sw) {
+		os << sw.watch() << "s (thread " << sw.threadTime() << "s, process " << sw.processTime()
+		   << "s, user " << sw.userTime() << "s, sys " << sw.sysTime() << "s)";
+		return os;
+	}
+
+}
+
+#endif //__HAD_CPUCLOCK_HPP__
@@ -0,0 +1,216 @@
+/**
+ * Lap recorders for StopWatch
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * LapHistogram: HDR style log-linear histogram of nanoseconds.
+ *     Values below 2^P have their own bucket, above that each power of 2
+ *     is split in 2^(P-1) buckets, so relative error is below 2^-(P-1)
+ *     (P = 8: < 0.8%). Recording is constant time with no allocation,
+ *     buckets are allocated once by the constructor.
+ *     Histograms of different threads can be merged.
+ *
+ * LapRing: the last N laps in nanoseconds, in a preallocated ring buffer.
+ *
+ * Use it as:
+ *     LapHistogram h;
+ *     StopWatch sw;
+ *     sw.record(&h);
+ *     for (...) {
+ *         sw.reset();
+ *         //...
+ *         sw.lap();    //records time since reset() or previous lap()
+ *     }
+ *     cout << h;
+ */
+
+#ifndef __HAD_LAPHISTOGRAM_HPP__
+#define __HAD_LAPHISTOGRAM_HPP__
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using std::ostream;
+
+namespace had {
+
+	class LapHistogram {
+		static constexpr int P = 8;
+		static constexpr uint64_t linear = uint64_t(1) << P;      //values with own bucket
+		static constexpr uint64_t half = linear / 2;               //buckets per power of 2
+		static constexpr size_t buckets = (66 - P) * half;
+
+		std::vector<uint64_t> counts;
+		uint64_t n = 0;
+		uint64_t minValue = std::numeric_limits<uint64_t>::max();
+		uint64_t maxValue = 0;
+		double sum = 0;
+		double sumsq = 0;
+
+		static size_t index(uint64_t v) {
+			if (v < linear) return v;
+			const int shift = std::bit_width(v) - P;
+			return (shift + 1) * half + ((v >> shift) - half);
+		}
+
+		//lowest value in bucket i
+		static uint64_t lowest(size_t i) {
+			if (i < linear) return i;
+			const int shift = i / half - 1;
+			return ((i % half) + half) << shift;
+		}
+
+		//highest value in bucket i
+		static uint64_t highest(size_t i) {
+			if (i < linear) return i;
+			const int shift = i / half - 1;
+			return lowest(i) + ((uint64_t(1) << shift) - 1);
+		}
+
+	public:
+		struct Summary {
+			uint64_t count;
+			double min, max, mean, stddev;
+			double p50, p90, p99, p999;
+		};
+
+		LapHistogram() : counts(buckets, 0) { }
+
+		/**
+		 * Constant time, no allocation
+		 *
+		 * @param ns value to record, in nanoseconds
+		 */
+		void record(uint64_t ns) {
+			++counts[index(ns)];
+			++n;
+			minValue = std::min(minValue, ns);
+			maxValue = std::max(maxValue, ns);
+			const double d = ns;
+			sum += d;
+			sumsq += d * d;
+		}
+
+		/**
+		 * Adds all recorded values of other to this
+		 */
+		LapHistogram &merge(const LapHistogram &other) {
+			for (size_t i = 0; i < buckets; ++i) counts[i] += other.counts[i];
+			n += other.n;
+			minValue = std::min(minValue, other.minValue);
+			maxValue = std::max(maxValue, other.maxValue);
+			sum += other.sum;
+			sumsq += other.sumsq;
+			return *this; //for method chain
+		}
+
+		void clear() {
+			std::fill(counts.begin(), counts.end(), 0);
+			n = 0;
+			minValue = std::numeric_limits<uint64_t>::max();
+			maxValue = 0;
+			sum = sumsq = 0;
+		}
+
+		uint64_t count() const { return n; }
+		uint64_t min() const { return n ? minValue : 0; }
+		uint64_t max() const { return maxValue; }
+		double mean() const { return n ? sum / n : 0; }
+
+		double stddev() const {
+			if (n == 0) return 0;
+			const double m = mean();
+			return std::sqrt(std::max(sumsq / n - m * m, 0.0));
+		}
+
+		/**
+		 * @param q quantile in [0, 1], e.g. 0.999 for p99.9
+		 * @return value at quantile q (middle of its bucket), 0 if empty
+		 */
+		double quantile(double q) const {
+			if (n == 0) return 0;
+			if (q <= 0) return minValue;
+			if (q >= 1) return maxValue;
+			const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * n)));
+			uint64_t cum = 0;
+			for (size_t i = 0; i < buckets; ++i) {
+				cum += counts[i];
+				if (cum >= rank) {
+					const double mid = (lowest(i) + static_cast<double>(highest(i))) / 2;
+					return std::clamp(mid, static_cast<double>(minValue), static_cast<double>(maxValue));
+				}
+			}
+			return maxValue;
+		}
+
+		Summary summary() const {
+			return { n, static_cast<double>(min()), static_cast<double>(max()), mean(), stddev(),
+					 quantile(0.5), quantile(0.9), quantile(0.99), quantile(0.999) };
+		}
+
+		/**
+		 * Prints summary in nanoseconds
+		 */
+		friend ostream &operator<<(ostream &os, const LapHistogram &h) {
+			const Summary s = h.summary();
+			os << "n=" << s.count << " min=" << s.min << "ns max=" << s.max
+			   << "ns mean=" << s.mean << "ns stddev=" << s.stddev
+			   << "ns p50=" << s.p50 << "ns p90=" << s.p90
+			   << "ns p99=" << s.p99 << "ns p99.9=" << s.p999 << "ns";
+			return os;
+		}
+	};
+
+
+	class LapRing {
+		std::vector<uint64_t> ring;
+		uint64_t n = 0;
+
+	public:
+		/**
+		 * @param capacity number of most recent laps kept
+		 */
+		explicit LapRing(size_t capacity) : ring(capacity) {
+			if (capacity == 0) throw std::invalid_argument("LapRing capacity must be > 0");
+		}
+
+		/**
+		 * @param ns value to record, in nanoseconds
+		 */
+		void record(uint64_t ns) { ring[n++ % ring.size()] = ns; }
+
+		/**
+		 * @return number of laps kept, at most capacity
+		 */
+		size_t size() const { return std::min<uint64_t>(n, ring.size()); }
+
+		/**
+		 * @return total number of laps recorded
+		 */
+		uint64_t recorded() const { return n; }
+
+		/**
+		 * @param i 0 is the oldest lap kept, size()-1 the most recent
+		 */
+		uint64_t operator[](size_t i) const { return ring[(n - size() + i) % ring.size()]; }
+
+		/**
+		 * @return laps kept, oldest first
+		 */
+		std::vector<uint64_t> values() const {
+			std::vector<uint64_t> ret(size());
+			for (size_t i = 0; i < ret.size(); ++i) ret[i] = (*this)[i];
+			return ret;
+		}
+
+		void clear() { n = 0; }
+	};
+
+}
+
+#endif //__HAD_LAPHISTOGRAM_HPP__
@@ -0,0 +1,219 @@
+/**
+ * Hardware and software performance counters (Linux perf_event_open)
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * PerfCounters opens one counter group for the calling thread:
+ *   hardware: cycles, instructions, branch misses, L1D read misses, LLC misses
+ *             (user mode only)
+ *   software: page faults, context switches, CPU migrations
+ * The whole group is read with a single read() at reset() and lap().
+ *
+ * When hardware counters cannot be opened (no PMU, e.g. in containers or
+ * VMs, or perf_event_paranoid too high), only software events are counted.
+ * Events that cannot be opened are reported as not available().
+ * Counts are scaled if the kernel multiplexed the group.
+ *
+ * Use it alone or attached to a StopWatch:
+ *     PerfCounters pc;
+ *     StopWatch sw;
+ *     sw.count(&pc);
+ *     sw.reset();
+ *     //...
+ *     sw.lap();
+ *     cout << sw << " " << pc;   //counts, IPC and misses per 1000 instructions
+ *
+ * Note: counters only count the thread that created them
+ */
+
+#ifndef __HAD_PERFCOUNTERS_HPP__
+#define __HAD_PERFCOUNTERS_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using std::ostream;
+
+namespace had {
+
+	class PerfCounters {
+	public:
+		enum Event {
+			cycles, instructions, branchMisses, l1dMisses, llcMisses,
+			pageFaults, contextSwitches, cpuMigrations
+		};
+		static constexpr int events = 8;
+
+	private:
+		struct Snapshot {
+			uint64_t enabled = 0, running = 0;
+			uint64_t values[events] = {};
+		};
+
+		int fd[events];
+		int slot[events];           //position of event in group read, -1 if not available
+		int leader = -1;
+		int opened = 0;
+		Snapshot start, stop;
+
+		static int open(uint32_t type, uint64_t config, bool excludeKernel, int group) {
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = group == -1;
+			attr.exclude_kernel = excludeKernel;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+		}
+
+		void add(Event e, uint32_t type, uint64_t config) {
+			//hardware events count user mode only, software events try kernel mode too
+			int f = -1;
+			if (type != PERF_TYPE_HARDWARE && type != PERF_TYPE_HW_CACHE) f = open(type, config, false, leader);
+			if (f < 0) f = open(type, config, true, leader);
+			if (f < 0) return;
+			if (leader == -1) leader = f;
+			fd[e] = f;
+			slot[e] = opened++;
+		}
+
+		void read(Snapshot &s) {
+			if (leader == -1) return;
+			uint64_t buf[3 + events];
+			if (::read(leader, buf, sizeof(buf)) < static_cast<ssize_t>((3 + opened) * sizeof(uint64_t))) return;
+			s.enabled = buf[1];
+			s.running = buf[2];
+			for (int e = 0; e < events; ++e)
+				if (slot[e] >= 0) s.values[e] = buf[3 + slot[e]];
+		}
+
+		static constexpr uint64_t cache(uint64_t id, uint64_t op, uint64_t result) {
+			return id | (op << 8) | (result << 16);
+		}
+
+	public:
+		/**
+		 * Opens and starts the counter group of the calling thread
+		 */
+		PerfCounters() {
+			for (int e = 0; e < events; ++e) {
+				fd[e] = -1;
+				slot[e] = -1;
+			}
+			add(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			if (leader != -1) {
+				add(instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+				add(branchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+				add(l1dMisses, PERF_TYPE_HW_CACHE,
+					cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+				add(llcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			}
+			add(pageFaults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+			add(contextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+			add(cpuMigrations, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS);
+			if (leader != -1) ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			reset();
+		}
+
+		~PerfCounters() {
+			//members before leader
+			for (int e = events - 1; e >= 0; --e)
+				if (fd[e] != -1) close(fd[e]);
+		}
+
+		PerfCounters(const PerfCounters &) = delete;
+		PerfCounters &operator=(const PerfCounters &) = delete;
+
+		/**
+		 * @return true if event e is counted
+		 */
+		bool available(Event e) const { return slot[e] >= 0; }
+
+		/**
+		 * @return true if hardware events are counted, false if only software events
+		 */
+		bool hardware() const { return available(cycles); }
+
+		/**
+		 * sets start and stop counts equal to current counts
+		 */
+		PerfCounters &reset() {
+			read(start);
+			stop = start;
+			return *this; //for method chain
+		}
+
+		/**
+		 * sets stop counts equal to current counts
+		 */
+		PerfCounters &lap() {
+			read(stop);
+			return *this; //for method chain
+		}
+
+		/**
+		 * @return count of e since last reset() until last lap(),
+		 *         scaled if multiplexed, 0 if not available
+		 */
+		uint64_t operator[](Event e) const {
+			if (!available(e)) return 0;
+			const uint64_t v = stop.values[e] - start.values[e];
+			const uint64_t enabled = stop.enabled - start.enabled;
+			const uint64_t running = stop.running - start.running;
+			if (running == 0 || running == enabled) return v;
+			return static_cast<uint64_t>(static_cast<double>(v) * enabled / running);
+		}
+
+		/**
+		 * @return instructions per cycle, 0 if not available
+		 */
+		double ipc() const {
+			const uint64_t c = (*this)[cycles];
+			return c ? static_cast<double>((*this)[instructions]) / c : 0;
+		}
+
+		/**
+		 * @return misses of e per 1000 instructions, 0 if not available
+		 */
+		double mpki(Event e) const {
+			const uint64_t i = (*this)[instructions];
+			return i ? 1000.0 * (*this)[e] / i : 0;
+		}
+
+		static const char *name(Event e) {
+			static const char *names[events] = {
+				"cycles", "instructions", "branch-misses", "L1D-misses", "LLC-misses",
+				"page-faults", "context-switches", "cpu-migrations"
+			};
+			return names[e];
+		}
+
+		/**
+		 * Prints available counts, IPC and misses per 1000 instructions
+		 */
+		friend ostream &operator<<(ostream &os, const PerfCounters &pc) {
+			const char *sep = "";
+			for (int e = 0; e < events; ++e) {
+				if (!pc.available(Event(e))) continue;
+				os << sep << name(Event(e)) << "=" << pc[Event(e)];
+				sep = " ";
+			}
+			if (pc.available(instructions)) {
+				os << " IPC=" << pc.ipc();
+				for (Event e : { branchMisses, l1dMisses, llcMisses })
+					if (pc.available(e)) os << " " << name(e) << "/Kinstr=" << pc.mpki(e);
+			}
+			return os;
+		}
+	};
+
+}
+
+#endif //__HAD_PERFCOUNTERS_HPP__
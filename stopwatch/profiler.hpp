@@ -0,0 +1,408 @@
+/**
+ * Scoped hierarchical profiler
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * HAD_PROFILE_SCOPE("name") records TSC time stamps at the beginning and at
+ * the end of the enclosing scope into a lock free single producer / single
+ * consumer ring buffer of the calling thread. Nothing is allocated on the hot
+ * path: each thread buffer is allocated once, on the first zone of the thread.
+ * If a buffer is full, zones are dropped (whole, never only begin or end)
+ * and counted. Buffers of finished threads are freed after their last
+ * collect(), so threads that come and go do not accumulate buffers.
+ *
+ * Profiler::collect() drains all thread buffers, from any thread, into:
+ *   - a call tree with count, inclusive and exclusive time of each zone
+ *   - optionally, a Chrome trace (chrome://tracing, https://ui.perfetto.dev)
+ * startCollector() drains periodically on a background thread.
+ *
+ * Compile with HAD_PROFILE_DISABLE defined to remove all zones.
+ *
+ * Use it as:
+ *     void f() {
+ *         HAD_PROFILE_SCOPE("f");
+ *         //...
+ *     }
+ *     Profiler::instance().collect();
+ *     Profiler::instance().writeReport(cout);
+ *     Profiler::instance().writeChromeTrace(file);
+ *
+ * Note: zone names must be string literals (or outlive the profiler)
+ */
+
+#ifndef __HAD_PROFILER_HPP__
+#define __HAD_PROFILER_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "tscclock.hpp"
+
+using std::ostream;
+using std::string;
+using std::vector;
+
+#define __HAD_PROFILE_CONCAT2(a, b) a##b
+#define __HAD_PROFILE_CONCAT(a, b) __HAD_PROFILE_CONCAT2(a, b)
+
+#ifdef HAD_PROFILE_DISABLE
+#define HAD_PROFILE_SCOPE(name) ((void)0)
+#else
+#define HAD_PROFILE_SCOPE(name) had::ProfileZone __HAD_PROFILE_CONCAT(__had_profile_zone_, __LINE__)(name)
+#endif
+
+namespace had {
+
+	class Profiler {
+	public:
+		struct Event {
+			const char *name;    //nullptr for end events
+			uint64_t ticks;
+		};
+
+		/**
+		 * Ring buffer of one thread
+		 * Producer: the thread, consumer: collect()
+		 */
+		struct ThreadBuffer {
+			vector<Event> ring;
+			const uint64_t mask;
+			std::atomic<uint64_t> head{0};     //next write, only producer writes
+			std::atomic<uint64_t> tail{0};     //next read, only consumer writes
+			std::atomic<uint64_t> dropped{0};
+			std::atomic<bool> finished{false};   //thread exited, no more events
+			uint64_t reserved = 0;             //slots reserved for end events of open zones
+			const int tid;
+
+			ThreadBuffer(size_t capacity, int tid) : ring(capacity), mask(capacity - 1), tid(tid) { }
+
+			/**
+			 * Begin is only accepted if there is room for its end,
+			 * so end events are never dropped
+			 */
+			bool begin(const char *name) {
+				const uint64_t h = head.load(std::memory_order_relaxed);
+				if (h - tail.load(std::memory_order_acquire) + reserved + 2 > ring.size()) {
+					dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				ring[h & mask] = { name, TscClock::now() };
+				head.store(h + 1, std::memory_order_release);
+				++reserved;
+				return true;
+			}
+
+			void end() {
+				const uint64_t t = TscClock::now();
+				const uint64_t h = head.load(std::memory_order_relaxed);
+				ring[h & mask] = { nullptr, t };
+				head.store(h + 1, std::memory_order_release);
+				--reserved;
+			}
+		};
+
+		/**
+		 * Call tree node, children are keyed by name
+		 */
+		struct Node {
+			string name;
+			uint64_t count = 0;
+			double inclusive = 0;     //seconds
+			double exclusive = 0;     //seconds
+			std::map<string, std::unique_ptr<Node>, std::less<>> children;
+
+			Node *child(std::string_view n) {
+				auto it = children.find(n);
+				if (it == children.end()) {
+					auto node = std::make_unique<Node>();
+					node->name = n;
+					it = children.emplace(node->name, std::move(node)).first;
+				}
+				return it->second.get();
+			}
+		};
+
+	private:
+		struct Frame {
+			Node *node;
+			const char *name;
+			uint64_t begin;
+			uint64_t childTicks;
+		};
+
+		//consumer side state of each thread buffer
+		struct Reader {
+			std::shared_ptr<ThreadBuffer> buffer;
+			vector<Frame> stack;
+		};
+
+		struct TraceEvent {
+			const char *name;
+			int tid;
+			uint64_t begin, end;
+		};
+
+		size_t capacity = 1 << 16;
+		std::mutex registryMutex;
+		vector<std::shared_ptr<ThreadBuffer>> registry;    //not yet read by collect()
+		int threads = 0;
+
+		std::mutex collectMutex;
+		vector<Reader> readers;
+		uint64_t droppedFreed = 0;      //dropped zones of freed buffers
+		Node root;
+		bool tracing = false;
+		vector<TraceEvent> trace;
+		uint64_t epoch = TscClock::now();
+
+		std::thread collector;
+		std::mutex collectorMutex;
+		std::condition_variable collectorWake;
+		bool collectorStop = false;
+
+		Profiler() { root.name = "root"; }
+
+		void drain(Reader &r) {
+			ThreadBuffer &b = *r.buffer;
+			const uint64_t h = b.head.load(std::memory_order_acquire);
+			uint64_t t = b.tail.load(std::memory_order_relaxed);
+			for (; t != h; ++t) {
+				const Event e = b.ring[t & b.mask];
+				if (e.name) {
+					Node *parent = r.stack.empty() ? &root : r.stack.back().node;
+					r.stack.push_back({ parent->child(e.name), e.name, e.ticks, 0 });
+				}
+				else if (!r.stack.empty()) {
+					const Frame f = r.stack.back();
+					r.stack.pop_back();
+					const uint64_t incl = e.ticks - f.begin;
+					f.node->count++;
+					f.node->inclusive += TscClock::toSeconds(incl);
+					f.node->exclusive += TscClock::toSeconds(incl - f.childTicks);
+					if (!r.stack.empty()) r.stack.back().childTicks += incl;
+					if (tracing) trace.push_back({ f.name, b.tid, f.begin, e.ticks });
+				}
+			}
+			b.tail.store(t, std::memory_order_release);
+		}
+
+		static void report(ostream &os, const Node &n, int depth) {
+			os << std::string(2 * depth, ' ') << std::left << std::setw(40 - 2 * depth) << n.name << std::right
+			   << std::setw(12) << n.count
+			   << std::setw(14) << n.inclusive * 1e3
+			   << std::setw(14) << n.exclusive * 1e3 << "\n";
+			for (auto &[name, child] : n.children) report(os, *child, depth + 1);
+		}
+
+		static string escaped(const char *s) {
+			string ret;
+			for (; *s; ++s) {
+				if (*s == '"' || *s == '\\') ret += '\\';
+				ret += *s;
+			}
+			return ret;
+		}
+
+	public:
+		Profiler(const Profiler &) = delete;
+		Profiler &operator=(const Profiler &) = delete;
+
+		~Profiler() { stopCollector(); }
+
+		static Profiler &instance() {
+			static Profiler p;
+			return p;
+		}
+
+		/**
+		 * @return buffer of calling thread, registered on first call
+		 */
+		ThreadBuffer &threadBuffer() {
+			//marks buffer finished on thread exit, collect() frees it
+			struct Owner {
+				std::shared_ptr<ThreadBuffer> buffer;
+				~Owner() { buffer->finished.store(true, std::memory_order_release); }
+			};
+			thread_local Owner owner { [this] {
+				std::lock_guard<std::mutex> lock(registryMutex);
+				auto b = std::make_shared<ThreadBuffer>(capacity, threads++);
+				registry.push_back(b);
+				return b;
+			}() };
+			return *owner.buffer;
+		}
+
+		/**
+		 * @param events capacity of buffers of threads not yet profiled, power of 2
+		 */
+		void bufferCapacity(size_t events) {
+			if (events < 4 || (events & (events - 1)))
+				throw std::invalid_argument("Profiler buffer capacity must be a power of 2 >= 4");
+			std::lock_guard<std::mutex> lock(registryMutex);
+			capacity = events;
+		}
+
+		/**
+		 * @param on keep zones for writeChromeTrace(), from next collect() on
+		 */
+		void tracingEnabled(bool on) {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			tracing = on;
+		}
+
+		/**
+		 * Drains all thread buffers into call tree (and trace),
+		 * frees buffers of finished threads
+		 */
+		void collect() {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			{
+				std::lock_guard<std::mutex> rlock(registryMutex);
+				for (auto &b : registry) readers.push_back({ std::move(b), {} });
+				registry.clear();
+			}
+			for (size_t i = 0; i < readers.size(); ) {
+				//finished before drain: all its events are visible to drain
+				const bool finished = readers[i].buffer->finished.load(std::memory_order_acquire);
+				drain(readers[i]);
+				if (finished) {
+					droppedFreed += readers[i].buffer->dropped.load(std::memory_order_relaxed);
+					readers[i] = std::move(readers.back());
+					readers.pop_back();
+				}
+				else ++i;
+			}
+		}
+
+		/**
+		 * @return number of thread buffers allocated, of running threads
+		 *         and of finished threads not yet collected
+		 */
+		size_t buffers() {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			std::lock_guard<std::mutex> rlock(registryMutex);
+			return readers.size() + registry.size();
+		}
+
+		/**
+		 * Collects every interval on a background thread, until stopCollector()
+		 */
+		void startCollector(std::chrono::milliseconds interval = std::chrono::milliseconds(100)) {
+			stopCollector();
+			collectorStop = false;
+			collector = std::thread([this, interval] {
+				std::unique_lock<std::mutex> lock(collectorMutex);
+				while (!collectorWake.wait_for(lock, interval, [this] { return collectorStop; }))
+					collect();
+			});
+		}
+
+		void stopCollector() {
+			if (!collector.joinable()) return;
+			{
+				std::lock_guard<std::mutex> lock(collectorMutex);
+				collectorStop = true;
+			}
+			collectorWake.notify_all();
+			collector.join();
+			collect();
+		}
+
+		/**
+		 * @return root of call tree, its children are the outermost zones.
+		 *         Only safe to read while no collect() runs
+		 */
+		const Node &tree() const { return root; }
+
+		/**
+		 * @return number of zones dropped because thread buffers were full
+		 */
+		uint64_t dropped() {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			std::lock_guard<std::mutex> rlock(registryMutex);
+			uint64_t d = droppedFreed;
+			for (auto &r : readers) d += r.buffer->dropped.load(std::memory_order_relaxed);
+			for (auto &b : registry) d += b->dropped.load(std::memory_order_relaxed);
+			return d;
+		}
+
+		/**
+		 * Clears call tree and trace, zones still open are kept open
+		 */
+		void clear() {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			//open zones point to nodes of the tree, so only reset statistics
+			struct { void operator()(Node &n) { n.count = 0; n.inclusive = n.exclusive = 0; for (auto &c : n.children) (*this)(*c.second); } } reset;
+			reset(root);
+			trace.clear();
+		}
+
+		/**
+		 * Prints call tree: zone, count, inclusive and exclusive time in ms
+		 */
+		void writeReport(ostream &os) {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+			os << std::left << std::setw(40) << "zone" << std::right << std::setw(12) << "count"
+			   << std::setw(14) << "incl ms" << std::setw(14) << "excl ms" << "\n" << std::fixed << std::setprecision(3);
+			for (auto &[name, child] : root.children) report(os, *child, 0);
+			os.flags(flags);
+			os.precision(precision);
+		}
+
+		/**
+		 * Writes collected zones as Chrome trace event format JSON
+		 * (needs tracingEnabled(true) before collect())
+		 */
+		void writeChromeTrace(ostream &os) {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+			os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+			for (size_t i = 0; i < trace.size(); ++i) {
+				const TraceEvent &e = trace[i];
+				const double ts = static_cast<int64_t>(e.begin - epoch) / TscClock::frequency() * 1e6;
+				const double dur = TscClock::toSeconds(e.end - e.begin) * 1e6;
+				os << "{\"name\":\"" << escaped(e.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+				   << ",\"ts\":" << ts << ",\"dur\":" << dur << "}" << (i + 1 < trace.size() ? "," : "") << "\n";
+			}
+			os << "],\"displayTimeUnit\":\"ns\"}\n";
+			os.flags(flags);
+			os.precision(precision);
+		}
+	};
+
+
+	/**
+	 * RAII zone, use with HAD_PROFILE_SCOPE(name)
+	 */
+	class ProfileZone {
+		Profiler::ThreadBuffer *buffer;
+
+	public:
+		explicit ProfileZone(const char *name) {
+			Profiler::ThreadBuffer &b = Profiler::instance().threadBuffer();
+			buffer = b.begin(name) ? &b : nullptr;
+		}
+
+		~ProfileZone() {
+			if (buffer) buffer->end();
+		}
+
+		ProfileZone(const ProfileZone &) = delete;
+		ProfileZone &operator=(const ProfileZone &) = delete;
+	};
+
+}
+
+#endif //__HAD_PROFILER_HPP__
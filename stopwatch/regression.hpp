@@ -0,0 +1,276 @@
+/**
+ * Benchmark baselines and regression detection
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * Baseline: samples (ns per iteration), median and MAD of each benchmark,
+ *           saved to and loaded from a text file.
+ * Regression::compare(): compares a run against a baseline with a two sided
+ *           Mann-Whitney U test on the samples. A benchmark is improved or
+ *           regressed only if the difference is significant (p < alpha) AND
+ *           its median changed more than threshold, so noise and tiny
+ *           significant differences are unchanged.
+ *
+ * Use it in a test binary as:
+ *     Benchmark bench;
+ *     bench.run("cmpbin", [&] { doNotOptimize(File::cmpbin(a, b)); });
+ *     REQUIRE(Regression().check(bench, "cmpbin.baseline", cout));
+ * check() saves a baseline if the file does not exist yet, delete the file
+ * to accept a new baseline.
+ *
+ * Baseline file format, one benchmark per line, tab separated:
+ *     name  median  mad  n  sample1 ... samplen
+ */
+
+#ifndef __HAD_REGRESSION_HPP__
+#define __HAD_REGRESSION_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "benchmark.hpp"
+
+using std::ostream;
+using std::string;
+using std::vector;
+
+namespace had {
+
+	class Baseline {
+	public:
+		struct Entry {
+			double median = 0, mad = 0;
+			vector<double> samples;        //ns per iteration
+		};
+
+	private:
+		static constexpr const char *header = "#had benchmark baseline v1";
+		std::map<string, Entry> entries;
+
+	public:
+		Baseline() = default;
+
+		/**
+		 * @param results of a benchmark run
+		 */
+		explicit Baseline(const vector<Benchmark::Result> &results) {
+			for (const Benchmark::Result &r : results) add(r.name, r.samples);
+		}
+
+		/**
+		 * Adds or replaces a benchmark
+		 */
+		Baseline &add(const string &name, const vector<double> &samples) {
+			if (name.empty() || name.find_first_of("\t\n") != string::npos)
+				throw std::invalid_argument("Baseline: invalid benchmark name: " + name);
+			if (samples.empty()) throw std::invalid_argument("Baseline: no samples for " + name);
+			Entry &e = entries[name];
+			e.samples = samples;
+			e.median = Benchmark::median(samples);
+			e.mad = Benchmark::mad(samples, e.median);
+			return *this; //for method chain
+		}
+
+		bool contains(const string &name) const { return entries.count(name); }
+		const Entry &operator[](const string &name) const { return entries.at(name); }
+		size_t size() const { return entries.size(); }
+		const std::map<string, Entry> &all() const { return entries; }
+
+		void save(ostream &os) const {
+			const auto precision = os.precision();
+			os << header << "\n" << std::setprecision(17);
+			for (auto &[name, e] : entries) {
+				os << name << "\t" << e.median << "\t" << e.mad << "\t" << e.samples.size();
+				for (double s : e.samples) os << "\t" << s;
+				os << "\n";
+			}
+			os.precision(precision);
+		}
+
+		void save(const string &path) const {
+			std::ofstream f(path);
+			if (!f) throw std::runtime_error("Baseline: cannot write " + path);
+			save(f);
+		}
+
+		/**
+		 * @throws runtime_error if the file is not a valid baseline
+		 */
+		static Baseline load(std::istream &is) {
+			string line;
+			if (!std::getline(is, line) || line != header)
+				throw std::runtime_error("Baseline: invalid header");
+			Baseline b;
+			while (std::getline(is, line)) {
+				if (line.empty()) continue;
+				const size_t tab = line.find('\t');
+				if (tab == string::npos) throw std::runtime_error("Baseline: invalid line: " + line);
+				std::istringstream fields(line.substr(tab + 1));
+				double median, mad;
+				size_t n;
+				if (!(fields >> median >> mad >> n) || n == 0)
+					throw std::runtime_error("Baseline: invalid line: " + line);
+				vector<double> samples(n);
+				for (double &s : samples)
+					if (!(fields >> s)) throw std::runtime_error("Baseline: missing samples: " + line);
+				//median and MAD are recomputed from the samples
+				b.add(line.substr(0, tab), samples);
+			}
+			return b;
+		}
+
+		static Baseline load(const string &path) {
+			std::ifstream f(path);
+			if (!f) throw std::runtime_error("Baseline: cannot read " + path);
+			return load(f);
+		}
+	};
+
+
+	class Regression {
+	public:
+		enum class Verdict { unchanged, improved, regressed, added, removed };
+
+		struct Comparison {
+			string name;
+			Verdict verdict;
+			double baseline;      //median ns, 0 if added
+			double current;       //median ns, 0 if removed
+			double change;        //current / baseline - 1
+			double pValue;        //Mann-Whitney U, 1 if added or removed
+		};
+
+		/**
+		 * Two sided Mann-Whitney U test, normal approximation with tie and
+		 * continuity corrections (fair from about 8 samples each)
+		 *
+		 * @return p value of the null hypothesis: a and b come from the same distribution
+		 */
+		static double mannWhitney(const vector<double> &a, const vector<double> &b) {
+			const size_t n1 = a.size(), n2 = b.size();
+			if (n1 == 0 || n2 == 0) return 1;
+			vector<std::pair<double, int>> all;
+			all.reserve(n1 + n2);
+			for (double x : a) all.push_back({ x, 0 });
+			for (double x : b) all.push_back({ x, 1 });
+			std::sort(all.begin(), all.end());
+
+			//rank sum of a, average ranks for ties
+			double ranksA = 0, ties = 0;
+			for (size_t i = 0; i < all.size();) {
+				size_t j = i;
+				while (j < all.size() && all[j].first == all[i].first) ++j;
+				const double rank = (i + 1 + j) / 2.0;
+				for (size_t k = i; k < j; ++k)
+					if (all[k].second == 0) ranksA += rank;
+				const double t = j - i;
+				ties += t * t * t - t;
+				i = j;
+			}
+
+			const double n = n1 + n2;
+			const double u = ranksA - n1 * (n1 + 1) / 2.0;
+			const double mean = n1 * n2 / 2.0;
+			const double var = n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1)));
+			if (var <= 0) return 1;    //all values equal
+			const double z = std::max(std::fabs(u - mean) - 0.5, 0.0) / std::sqrt(var);
+			return std::erfc(z / std::sqrt(2.0));
+		}
+
+	private:
+		double threshold, alpha;
+
+	public:
+		/**
+		 * @param threshold  minimum relative change of median, e.g. 0.05 for 5%
+		 * @param alpha      significance level of the Mann-Whitney U test
+		 */
+		explicit Regression(double threshold = 0.05, double alpha = 0.01) : threshold(threshold), alpha(alpha) {
+			if (threshold < 0 || alpha <= 0 || alpha >= 1)
+				throw std::invalid_argument("Regression: threshold must be >= 0 and alpha in ]0, 1[");
+		}
+
+		Comparison compare(const string &name, const Baseline::Entry &base, const Baseline::Entry &cur) const {
+			Comparison c { name, Verdict::unchanged, base.median, cur.median, 0, 1 };
+			c.change = base.median > 0 ? cur.median / base.median - 1 : 0;
+			c.pValue = mannWhitney(base.samples, cur.samples);
+			if (c.pValue < alpha && std::fabs(c.change) > threshold)
+				c.verdict = c.change > 0 ? Verdict::regressed : Verdict::improved;
+			return c;
+		}
+
+		/**
+		 * @return one comparison per benchmark in baseline or current, sorted by name
+		 */
+		vector<Comparison> compare(const Baseline &baseline, const Baseline &current) const {
+			vector<Comparison> ret;
+			for (auto &[name, e] : baseline.all()) {
+				if (current.contains(name)) ret.push_back(compare(name, e, current[name]));
+				else ret.push_back({ name, Verdict::removed, e.median, 0, 0, 1 });
+			}
+			for (auto &[name, e] : current.all())
+				if (!baseline.contains(name)) ret.push_back({ name, Verdict::added, 0, e.median, 0, 1 });
+			std::sort(ret.begin(), ret.end(), [](auto &a, auto &b) { return a.name < b.name; });
+			return ret;
+		}
+
+		/**
+		 * @return true if no benchmark regressed
+		 */
+		static bool passed(const vector<Comparison> &comparisons) {
+			return std::none_of(comparisons.begin(), comparisons.end(),
+								[](auto &c) { return c.verdict == Verdict::regressed; });
+		}
+
+		/**
+		 * Compares results of bench against baseline file, or saves them as the
+		 * baseline if the file does not exist
+		 *
+		 * @param report  comparison table is written here
+		 * @return true if no benchmark regressed
+		 */
+		bool check(const Benchmark &bench, const string &baselinePath, ostream &report = std::cout) const {
+			const Baseline current(bench.results());
+			if (!std::ifstream(baselinePath)) {
+				current.save(baselinePath);
+				report << "Baseline saved to " << baselinePath << "\n";
+				return true;
+			}
+			const vector<Comparison> cmp = compare(Baseline::load(baselinePath), current);
+			write(report, cmp);
+			return passed(cmp);
+		}
+
+		static const char *name(Verdict v) {
+			static const char *names[] = { "unchanged", "improved", "REGRESSED", "added", "removed" };
+			return names[static_cast<int>(v)];
+		}
+
+		/**
+		 * Prints a table of comparisons
+		 */
+		static void write(ostream &os, const vector<Comparison> &comparisons) {
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+			os << std::left << std::setw(40) << "benchmark" << std::right << std::setw(14) << "baseline ns"
+			   << std::setw(14) << "current ns" << std::setw(10) << "change" << std::setw(10) << "p" << "  verdict\n";
+			for (const Comparison &c : comparisons) {
+				os << std::left << std::setw(40) << c.name << std::right << std::fixed << std::setprecision(1)
+				   << std::setw(14) << c.baseline << std::setw(14) << c.current
+				   << std::setw(9) << c.change * 100 << "%" << std::setprecision(4) << std::setw(10) << c.pValue
+				   << "  " << name(c.verdict) << "\n";
+			}
+			os.flags(flags);
+			os.precision(precision);
+		}
+	};
+
+}
+
+#endif //__HAD_REGRESSION_HPP__
@@ -0,0 +1,420 @@
+/**
+ * Sampling profiler (Linux)
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * start() creates a timer on the CPU time of the calling thread
+ * (CLOCK_THREAD_CPUTIME_ID) that sends SIGPROF to that thread every interval.
+ * The signal handler walks the frame pointers of the interrupted stack into
+ * a preallocated lock free ring buffer; nothing is allocated or locked in
+ * the handler. backtrace() is not used: its unwinder can take the
+ * dl_iterate_phdr lock, which the interrupted thread may hold (deadlock).
+ * Samples are symbolized offline (dladdr, demangled) by collect(), which can
+ * run on any thread, also while sampling.
+ *
+ * Output:
+ *   writeFolded(): one line per distinct stack "main;f;g count", the input
+ *                  of flamegraph.pl (https://github.com/brendangregg/FlameGraph)
+ *   writeTop():    functions with most samples, self and inclusive
+ *
+ * Use it as:
+ *     Sampler sampler;
+ *     sampler.start();
+ *     apptest.exec(studentMain, args);
+ *     sampler.stop();
+ *     sampler.writeTop(cout, 10);
+ *     sampler.writeFolded(file);
+ *
+ * Notes:
+ *   - Only one Sampler samples at a time, on one or more threads (start()
+ *     and stop() on each). Only CPU time is sampled, waiting is not.
+ *   - CPU timers expire on kernel ticks, so intervals below the tick period
+ *     (1 to 4ms, CONFIG_HZ) sample at the tick period.
+ *   - Stacks are complete only through code compiled with frame pointers
+ *     (-fno-omit-frame-pointer, default at -O0). Without them a stack ends
+ *     early or skips callers; frames are only read inside the stack of the
+ *     thread, so a wrong frame pointer never crashes.
+ *     The caller of a function interrupted before it saved its frame
+ *     pointer (first instructions) is not in the stack.
+ *   - Link with -rdynamic to get names of functions of the executable,
+ *     otherwise they are shown as module+offset. Static functions have no names.
+ *   - The SIGPROF handler stays installed after stop(), ignoring late signals.
+ *   - The destructor waits for handlers already running in other threads,
+ *     so it can destroy a Sampler while they are sampled.
+ */
+
+#ifndef __HAD_SAMPLER_HPP__
+#define __HAD_SAMPLER_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/syscall.h>
+#include <sys/ucontext.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using std::ostream;
+using std::string;
+using std::vector;
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace had {
+
+	class Sampler {
+	public:
+		static constexpr int maxDepth = 64;
+
+	private:
+		struct Slot {
+			std::atomic<uint64_t> sequence{0};  //position + 1 when written
+			int depth = 0;
+			void *frames[maxDepth];
+		};
+
+		const std::chrono::microseconds interval;
+		const uint64_t capacity;
+		std::unique_ptr<Slot[]> ring;
+		std::atomic<uint64_t> head{0};         //next slot to claim, signal handlers
+		std::atomic<uint64_t> tail{0};         //next slot to read, collect()
+		std::atomic<uint64_t> lost{0};
+
+		std::mutex timersMutex;
+		std::map<pid_t, timer_t> timers;       //per sampled thread
+
+		std::mutex collectMutex;
+		std::map<vector<void *>, uint64_t> stacks;  //outermost frame first
+		uint64_t samples = 0;
+
+		static std::atomic<Sampler *> &active() {
+			static std::atomic<Sampler *> a{nullptr};
+			return a;
+		}
+
+		//handlers running: the destructor waits for them before freeing the ring
+		static std::atomic<int> &inHandler() {
+			static std::atomic<int> n{0};
+			return n;
+		}
+
+		//stack of each sampled thread, set by start(): frames are only read inside it
+		struct StackBounds {
+			uintptr_t low = 0, high = 0;
+		};
+
+		static StackBounds &stackBounds() {
+			static thread_local StackBounds b;
+			return b;
+		}
+
+		//interrupted pc and frame pointer
+		static void interrupted(void *context, uintptr_t &pc, uintptr_t &fp) {
+			const ucontext_t *uc = static_cast<const ucontext_t *>(context);
+#if defined(__x86_64__)
+			pc = uc->uc_mcontext.gregs[REG_RIP];
+			fp = uc->uc_mcontext.gregs[REG_RBP];
+#elif defined(__aarch64__)
+			pc = uc->uc_mcontext.pc;
+			fp = uc->uc_mcontext.regs[29];
+#else
+			(void) uc;
+			pc = fp = 0;
+#endif
+		}
+
+		/**
+		 * Frame records are { caller frame pointer, return address } at the
+		 * frame pointer, x86-64 and AArch64, caller frames at higher addresses
+		 *
+		 * @return number of frames, innermost first
+		 */
+		static int walk(void *context, void **frames) {
+			uintptr_t pc, fp;
+			interrupted(context, pc, fp);
+			if (!pc) return 0;
+			int n = 0;
+			frames[n++] = reinterpret_cast<void *>(pc);
+			const StackBounds &b = stackBounds();
+			while (n < maxDepth && fp % sizeof(uintptr_t) == 0 && fp >= b.low && fp + 2 * sizeof(uintptr_t) <= b.high) {
+				const uintptr_t *record = reinterpret_cast<const uintptr_t *>(fp);
+				if (!record[1]) break;
+				frames[n++] = reinterpret_cast<void *>(record[1]);
+				if (record[0] <= fp) break;
+				fp = record[0];
+			}
+			return n;
+		}
+
+		static void handler(int, siginfo_t *, void *context) {
+			//counted before reading active(), which the destructor clears before waiting
+			inHandler().fetch_add(1, std::memory_order_seq_cst);
+			Sampler *s = active().load(std::memory_order_seq_cst);
+			if (s) {
+				const int savedErrno = errno;
+				sample(s, context);
+				errno = savedErrno;
+			}
+			inHandler().fetch_sub(1, std::memory_order_release);
+		}
+
+		static void sample(Sampler *s, void *context) {
+			uint64_t h = s->head.load(std::memory_order_relaxed);
+			do {
+				if (h - s->tail.load(std::memory_order_acquire) >= s->capacity) {
+					s->lost.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			} while (!s->head.compare_exchange_weak(h, h + 1, std::memory_order_relaxed));
+
+			Slot &slot = s->ring[h % s->capacity];
+			slot.depth = walk(context, slot.frames);
+			slot.sequence.store(h + 1, std::memory_order_release);
+		}
+
+		static void installHandler() {
+			static std::once_flag once;
+			std::call_once(once, [] {
+				struct sigaction sa;
+				std::memset(&sa, 0, sizeof(sa));
+				sa.sa_sigaction = handler;
+				sa.sa_flags = SA_SIGINFO | SA_RESTART;
+				sigemptyset(&sa.sa_mask);
+				if (sigaction(SIGPROF, &sa, nullptr) != 0)
+					throw std::runtime_error("Sampler: cannot install SIGPROF handler");
+			});
+		}
+
+		static pid_t tid() { return static_cast<pid_t>(syscall(SYS_gettid)); }
+
+		//frames after the first are return addresses, point inside the call instruction
+		static string symbol(void *addr, bool returnAddress) {
+			void *a = static_cast<char *>(addr) - (returnAddress ? 1 : 0);
+			Dl_info info;
+			if (dladdr(a, &info) && info.dli_sname) {
+				int status = 0;
+				char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+				string name = status == 0 ? demangled : info.dli_sname;
+				std::free(demangled);
+				return name;
+			}
+			std::stringstream ss;
+			if (dladdr(a, &info) && info.dli_fname) {
+				const char *base = std::strrchr(info.dli_fname, '/');
+				ss << (base ? base + 1 : info.dli_fname) << "+0x" << std::hex
+				   << (static_cast<char *>(a) - static_cast<char *>(info.dli_fbase));
+			}
+			else ss << addr;
+			return ss.str();
+		}
+
+		//symbolized stacks, outermost frame first
+		std::map<vector<string>, uint64_t> symbolized() {
+			collect();
+			std::lock_guard<std::mutex> lock(collectMutex);
+			std::unordered_map<void *, string> names[2];
+			std::map<vector<string>, uint64_t> ret;
+			for (auto &[frames, count] : stacks) {
+				vector<string> stack(frames.size());
+				for (size_t i = 0; i < frames.size(); ++i) {
+					const bool returnAddress = i + 1 < frames.size();
+					auto it = names[returnAddress].find(frames[i]);
+					if (it == names[returnAddress].end())
+						it = names[returnAddress].emplace(frames[i], symbol(frames[i], returnAddress)).first;
+					stack[i] = it->second;
+				}
+				ret[stack] += count;
+			}
+			return ret;
+		}
+
+	public:
+		/**
+		 * @param interval  CPU time between samples of each thread
+		 * @param capacity  samples buffered until collect(), more are lost
+		 */
+		explicit Sampler(std::chrono::microseconds interval = std::chrono::microseconds(1000), size_t capacity = 1 << 14)
+				: interval(interval), capacity(capacity), ring(new Slot[capacity]) {
+			if (interval.count() <= 0 || capacity == 0)
+				throw std::invalid_argument("Sampler interval and capacity must be > 0");
+		}
+
+		~Sampler() {
+			std::lock_guard<std::mutex> lock(timersMutex);
+			for (auto &[t, timer] : timers) timer_delete(timer);
+			Sampler *self = this;
+			active().compare_exchange_strong(self, nullptr, std::memory_order_seq_cst);
+			//handlers of other threads that already read this still write the ring
+			while (inHandler().load(std::memory_order_acquire) > 0) std::this_thread::yield();
+		}
+
+		Sampler(const Sampler &) = delete;
+		Sampler &operator=(const Sampler &) = delete;
+
+		/**
+		 * Starts sampling the calling thread
+		 */
+		Sampler &start() {
+			installHandler();
+			//before the timer: the handler reads the bounds of this thread
+			pthread_attr_t attr;
+			if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+				void *addr;
+				size_t size;
+				if (pthread_attr_getstack(&attr, &addr, &size) == 0)
+					stackBounds() = { reinterpret_cast<uintptr_t>(addr), reinterpret_cast<uintptr_t>(addr) + size };
+				pthread_attr_destroy(&attr);
+			}
+			std::lock_guard<std::mutex> lock(timersMutex);
+			Sampler *expected = nullptr;
+			if (!active().compare_exchange_strong(expected, this) && expected != this)
+				throw std::logic_error("Sampler: another Sampler is running");
+			const pid_t t = tid();
+			if (timers.count(t)) return *this;
+
+			sigevent sev;
+			std::memset(&sev, 0, sizeof(sev));
+			sev.sigev_notify = SIGEV_THREAD_ID;
+			sev.sigev_signo = SIGPROF;
+			sev.sigev_notify_thread_id = t;
+			timer_t timer;
+			if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer) != 0) {
+				if (timers.empty()) active().store(nullptr);
+				throw std::runtime_error(string("Sampler: timer_create failed: ") + std::strerror(errno));
+			}
+			itimerspec its;
+			its.it_interval.tv_sec = interval.count() / 1000000;
+			its.it_interval.tv_nsec = (interval.count() % 1000000) * 1000;
+			its.it_value = its.it_interval;
+			timer_settime(timer, 0, &its, nullptr);
+			timers[t] = timer;
+			return *this; //for method chain
+		}
+
+		/**
+		 * Stops sampling the calling thread
+		 */
+		Sampler &stop() {
+			std::lock_guard<std::mutex> lock(timersMutex);
+			auto it = timers.find(tid());
+			if (it == timers.end()) return *this;
+			timer_delete(it->second);
+			timers.erase(it);
+			if (timers.empty()) active().store(nullptr, std::memory_order_release);
+			return *this; //for method chain
+		}
+
+		/**
+		 * Moves samples from ring buffer to stack counts (not symbolized yet)
+		 */
+		void collect() {
+			std::lock_guard<std::mutex> lock(collectMutex);
+			uint64_t t = tail.load(std::memory_order_relaxed);
+			for (;; ++t) {
+				Slot &slot = ring[t % capacity];
+				if (slot.sequence.load(std::memory_order_acquire) != t + 1) break;
+				vector<void *> frames(slot.frames, slot.frames + slot.depth);
+				std::reverse(frames.begin(), frames.end());
+				++stacks[frames];
+				++samples;
+				tail.store(t + 1, std::memory_order_release);
+			}
+		}
+
+		/**
+		 * @return number of samples collected
+		 */
+		uint64_t count() {
+			collect();
+			std::lock_guard<std::mutex> lock(collectMutex);
+			return samples;
+		}
+
+		/**
+		 * @return number of samples lost because ring buffer was full
+		 */
+		uint64_t dropped() const { return lost.load(std::memory_order_relaxed); }
+
+		/**
+		 * Discards collected samples
+		 */
+		void clear() {
+			collect();
+			std::lock_guard<std::mutex> lock(collectMutex);
+			stacks.clear();
+			samples = 0;
+		}
+
+		/**
+		 * Writes folded stacks: "outer;...;inner count" per line, for flamegraph.pl
+		 */
+		void writeFolded(ostream &os) {
+			for (auto &[stack, count] : symbolized()) {
+				for (size_t i = 0; i < stack.size(); ++i) {
+					//';' separates frames in folded format
+					string name = stack[i];
+					std::replace(name.begin(), name.end(), ';', ':');
+					os << (i ? ";" : "") << name;
+				}
+				os << " " << count << "\n";
+			}
+		}
+
+		/**
+		 * Writes the n functions with most samples:
+		 *   self:      samples in the function itself
+		 *   inclusive: samples in the function or functions it called
+		 */
+		void writeTop(ostream &os, size_t n = 20) {
+			std::map<string, uint64_t> self, inclusive;
+			uint64_t total = 0;
+			for (auto &[stack, count] : symbolized()) {
+				total += count;
+				if (stack.empty()) continue;
+				self[stack.back()] += count;
+				//recursive functions count once per sample
+				vector<string> unique = stack;
+				std::sort(unique.begin(), unique.end());
+				unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+				for (auto &f : unique) inclusive[f] += count;
+			}
+
+			vector<std::pair<string, uint64_t>> top(self.begin(), self.end());
+			std::sort(top.begin(), top.end(), [](auto &a, auto &b) { return a.second > b.second; });
+			if (top.size() > n) top.resize(n);
+
+			const auto flags = os.flags();
+			const auto precision = os.precision();
+			os << total << " samples\n" << std::right << std::setw(10) << "self %" << std::setw(12) << "inclusive %"
+			   << "  function\n" << std::fixed << std::setprecision(2);
+			for (auto &[name, count] : top)
+				os << std::setw(10) << 100.0 * count / total << std::setw(12) << 100.0 * inclusive[name] / total
+				   << "  " << name << "\n";
+			os.flags(flags);
+			os.precision(precision);
+		}
+	};
+
+}
+
+#endif //__HAD_SAMPLER_HPP__
@@ -4,16 +4,29 @@
  * v2.1 hdaniel@ualg.pt 2019 apr
  * v3.0 hdaniel@ualg.pt 2019 apr C++14
  * v3.1 hdaniel@ualg.pt 2019 may C++14
+ * v4.0 hdaniel@ualg.pt 2026 oct C++20
  * Changelog:
  *      return time() from last reset() to last lap()
  *      Note:  Time is always real time, so it counts user inputs and event waits
+ *      v4.0: StopWatch is BasicStopWatch<Clock> with a clock that reads raw ticks,
+ *            ticks are only converted to seconds in watch().
+ *            See tscclock.hpp for TscStopWatch, a low overhead clock.
+ *            record() stores lap deltas in a LapHistogram and/or LapRing.
+ *            count() reads PerfCounters (Linux) on each reset() and lap().
  */
 
 #ifndef __HAD_STOPWATCH_HPP__
 #define __HAD_STOPWATCH_HPP__
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include "laphistogram.hpp"
+#ifdef __linux__
+#include "perfcounters.hpp"
+#endif
 
 using namespace std::chrono;
 
@@ -21,50 +34,136 @@ using std::ostream;
 
 namespace had {
 
-	class StopWatch {
-		time_point <high_resolution_clock> start, stop;
-		double elapsedTime;  //real elapsed time in seconds
+	/**
+	 * Clocks used by BasicStopWatch have:
+	 *   typedef ticks:                     raw time stamp type
+	 *   static ticks now():                current time stamp
+	 *   static double toSeconds(ticks t):  converts a difference of time stamps to seconds
+	 */
+	struct ChronoClock {
+		typedef high_resolution_clock::rep ticks;
+
+		static ticks now() { return high_resolution_clock::now().time_since_epoch().count(); }
+
+		static double toSeconds(ticks t) {
+			return static_cast<double>(t) * high_resolution_clock::period::num / high_resolution_clock::period::den;
+		}
+	};
+
+
+	template<class Clock>
+	class BasicStopWatch {
+		typename Clock::ticks start, stop;
+		LapHistogram *histogram = nullptr;
+		LapRing *ring = nullptr;
+#ifdef __linux__
+		PerfCounters *counters = nullptr;
+#endif
 
 	public:
+		typedef Clock clock;
+
 		/**
 		 * Creates StopWatch object and resets timer
 		 */
-		StopWatch() { reset(); }
+		BasicStopWatch() { reset(); }
 
 		/**
 		 * sets start and stop times equals to current time
 		 */
-		StopWatch &reset() {
-			elapsedTime = 0;
-			start = stop = high_resolution_clock::now();
+		BasicStopWatch &reset() {
+#ifdef __linux__
+			if (counters) counters->reset();
+#endif
+			start = stop = Clock::now();
 			return *this; //for method chain
 		}
 
 		/**
 		 * sets stop times equals to current time
 		 */
-		StopWatch &lap() {
-			stop = high_resolution_clock::now();
-			elapsedTime = duration<double>(stop - start).count();
+		BasicStopWatch &lap() {
+			const typename Clock::ticks prev = stop;
+			stop = Clock::now();
+#ifdef __linux__
+			if (counters) counters->lap();
+#endif
+			if (histogram || ring) {
+				const uint64_t ns = std::llround(std::max(Clock::toSeconds(stop - prev), 0.0) * 1e9);
+				if (histogram) histogram->record(ns);
+				if (ring) ring->record(ns);
+			}
+			return *this; //for method chain
+		}
+
+		/**
+		 * Recording mode: each lap() records the time since previous lap()
+		 * or reset(), in nanoseconds. Recorders are not owned by StopWatch.
+		 *
+		 * @param h histogram to record laps, nullptr to stop recording
+		 * @param r ring buffer to record laps, nullptr to stop recording
+		 */
+		BasicStopWatch &record(LapHistogram *h, LapRing *r = nullptr) {
+			histogram = h;
+			ring = r;
 			return *this; //for method chain
 		}
 
+#ifdef __linux__
+		/**
+		 * Counting mode: reset() and lap() also reset() and lap() pc,
+		 * so its counts cover the same section. pc is not owned by StopWatch.
+		 *
+		 * @param pc performance counters, nullptr to stop counting
+		 */
+		BasicStopWatch &count(PerfCounters *pc) {
+			counters = pc;
+			return *this; //for method chain
+		}
+#endif
+
 		/**
 		 * Returns time elapsed since last reset() until last lap()
 		 * DOES count user input like wait keypress
 		 */
 		double watch() const {
-			return elapsedTime;
+			return Clock::toSeconds(stop - start);
 			//No method chain here, since returns time
 		}
 
-		friend ostream& operator << (ostream&, StopWatch&);
+		/**
+		 * @return raw clock ticks elapsed since last reset() until last lap()
+		 */
+		typename Clock::ticks ticks() const { return stop - start; }
+
+		/**
+		 * Time measured by an empty reset(), lap() section,
+		 * can be subtracted from watch() of very short sections.
+		 * Measured once, as the minimum of several runs
+		 *
+		 * @return self overhead in seconds
+		 */
+		static double overhead() {
+			static const double value = [] {
+				BasicStopWatch sw;
+				typename Clock::ticks best = sw.ticks();
+				for (int i = 0; i < 1000; ++i) {
+					sw.reset().lap();
+					if (i == 0 || sw.ticks() < best) best = sw.ticks();
+				}
+				return Clock::toSeconds(best);
+			}();
+			return value;
+		}
 	};
 
+	typedef BasicStopWatch<ChronoClock> StopWatch;
+
 	/**
 	 * Prints real elapsed time in seconds
 	 */
-	ostream &operator<<(ostream &os, StopWatch &sw) {
+	template<class Clock>
+	ostream &operator<<(ostream &os, const BasicStopWatch<Clock> &sw) {
 		os << sw.watch() << "s";
 		return os;
 	}
@@ -72,4 +171,3 @@ namespace had {
 }
 
 #endif //__HAD_STOPWATCH_HPP__
-
@@ -2,12 +2,17 @@
  * StopWatch class definition
  * v2.0 hdaniel@ualg.pt 2011
  * v2.1 hdaniel@ualg.pt 2019 apr
+ * v2.2 hdaniel@ualg.pt 2026 oct
  * Changelog:
  *      return cpuTime() and realTime() from last reset() to last lap()
  *      Note0: cpuTime() is read first, so should be a little slower, even if realTime()
  *             measure was not delayed by waiting for some event.
  *		Note1: unlike previous versions cpuTime() and realTime() do not call lap()
- *		Note2: Current implementation of realTime() has miliseconds resolution.
+ *		Note2: v2.2 replaces deprecated ftime() and process wide clock() with
+ *		       clock_gettime(CLOCK_MONOTONIC) and clock_gettime(CLOCK_PROCESS_CPUTIME_ID),
+ *		       both with nanosecond resolution.
+ *		       For thread CPU time and user/sys split see CpuStopWatch in cpuclock.hpp
+ *		Note3: Previous implementation of realTime() had miliseconds resolution.
  *		       std::chrono can be used in C++14 to get real time with higher resolution
  *		       (however duration.count() is an integer):
  *
@@ -22,14 +27,17 @@
  *
  */
 
-#include <sys/timeb.h>
 #include <time.h>
 #include <iostream>
 using namespace std;
 
 class StopWatch {
-struct timeb starttm, endtm;
-clock_t start, end;
+struct timespec starttm, endtm;
+struct timespec start, end;
+
+	static double seconds(const timespec &t0, const timespec &t1) {
+		return (t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+	}
 
 public:
 	/**
@@ -41,17 +49,18 @@ public:
 	 * sets start and end times equals to current time
 	 */
 	void reset()	{
-		ftime(&starttm);
+		clock_gettime(CLOCK_MONOTONIC, &starttm);
 		endtm = starttm;
-		start = end = clock();
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start);
+		end = start;
 	}
 
 	/**
 	 * sets end times equals to current time
 	 */
 	void lap() {
-        end=clock();
-		ftime(&endtm);
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &end);
+		clock_gettime(CLOCK_MONOTONIC, &endtm);
 	}
 
 	/**
@@ -59,11 +68,7 @@ public:
 	 * DOES count user input like wait keypress
 	 */
 	double realTime() {
-		const time_t startsec = starttm.time;
-		const time_t endsec = endtm.time;
-		const short startms = starttm.millitm;	
-		const short endms = endtm.millitm;
-		return (endsec-startsec)+((double)(endms-startms)/1000);
+		return seconds(starttm, endtm);
 	};
 
 	/**
@@ -72,7 +77,7 @@ public:
 	 * (just processor ticks)
      */
 	double cpuTime() {
-		return ((double)(end-start)/CLOCKS_PER_SEC);
+		return seconds(start, end);
 	};
 	//friend ostream& operator << (ostream& os, StopWatch& c);
 };
@@ -0,0 +1,113 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// Built with -O2: doNotOptimize() asm constraints are only checked when optimizing
+//
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../benchmark.hpp"
+
+using namespace had;
+
+TEST_CASE( "Benchmark harness", "[Benchmark]" ) {
+
+	Benchmark::Options opt;
+	opt.warmup = 0.001;
+	opt.minTime = 0.001;
+	opt.repetitions = 3;
+
+	SECTION("doNotOptimize lvalues and rvalues") {
+		int i = 1;
+		uint64_t u = 2;
+		double d = 3;
+		std::vector<int> v(4, 5);
+		struct Big { char bytes[64]; } big{};
+		doNotOptimize(i);
+		doNotOptimize(u);
+		doNotOptimize(d);
+		doNotOptimize(v);
+		doNotOptimize(big);
+		doNotOptimize(i + 1);
+		doNotOptimize(static_cast<const uint64_t &>(u));
+		clobberMemory();
+		REQUIRE(i == 1);
+		REQUIRE(u == 2);
+		REQUIRE(d == 3);
+		REQUIRE(v.size() == 4);
+
+		Benchmark bench(opt);
+		const auto &r = bench.run("sum", [&] {
+			uint64_t s = 0;
+			for (int k = 0; k < 100; ++k) s += k;
+			doNotOptimize(s);
+		}, 0, 100);
+		REQUIRE(r.iterations > 0);
+		REQUIRE(r.samples.size() + r.rejected == 3);
+		REQUIRE(r.itemsPerSecond > 0);
+	}
+
+	SECTION("CSV and JSON names") {
+		Benchmark bench(opt);
+		bench.run("say \"hi\", \\ bye", [] { clobberMemory(); });
+
+		std::ostringstream csv;
+		bench.writeCSV(csv);
+		REQUIRE(csv.str().find("\n\"say \"\"hi\"\", \\ bye\",") != string::npos);
+
+		std::ostringstream json;
+		bench.writeJSON(json);
+		REQUIRE(json.str().find("\"name\": \"say \\\"hi\\\", \\\\ bye\"") != string::npos);
+	}
+
+	SECTION("JSON control characters") {
+		Benchmark bench(opt);
+		bench.run("a\nb\tc\x01" "d\x1f", [] { clobberMemory(); });
+		std::ostringstream json;
+		bench.writeJSON(json);
+		REQUIRE(json.str().find("\"name\": \"a\\nb\\tc\\u0001d\\u001f\"") != string::npos);
+	}
+
+	SECTION("invalid options") {
+		Benchmark::Options bad = opt;
+		bad.repetitions = 0;
+		REQUIRE_THROWS_AS(Benchmark(bad), std::invalid_argument);
+		bad = opt;
+		bad.minTime = 0;
+		REQUIRE_THROWS_AS(Benchmark(bad), std::invalid_argument);
+		bad.minTime = -1;
+		REQUIRE_THROWS_AS(Benchmark(bad), std::invalid_argument);
+
+		bool ran = false;
+		auto benchmarks = [&ran](Benchmark &) { ran = true; };
+		for (const char *arg : { "--reps=0", "--reps=-2", "--min-time=0", "--min-time=-1", "--reps=x", "--min-time=" }) {
+			char name[] = "bench";
+			char *argv[] = { name, const_cast<char *>(arg), nullptr };
+			REQUIRE(Benchmark::main(2, argv, benchmarks) == 1);
+		}
+		REQUIRE(!ran);
+	}
+
+	SECTION("stream format is restored") {
+		Benchmark bench(opt);
+		bench.run("noop", [] { clobberMemory(); });
+
+		std::ostringstream os;
+		os << std::setprecision(3);
+		const auto flags = os.flags();
+		bench.writeCSV(os);
+		bench.writeJSON(os);
+		os << bench;
+		REQUIRE(os.flags() == flags);
+		REQUIRE(os.precision() == 3);
+
+		std::ostringstream check;
+		check << 1.23456789;
+		os.str("");
+		os << 1.23456789;
+		REQUIRE(os.str() == "1.23");
+		REQUIRE(check.str() == "1.23457");
+	}
+}
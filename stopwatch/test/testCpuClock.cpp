@@ -0,0 +1,56 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include "../cpuclock.hpp"
+
+using namespace had;
+
+//keeps CPU busy for about s seconds of thread CPU time
+static void spin(double s) {
+	BasicStopWatch<ThreadCpuClock> sw;
+	volatile uint64_t x = 0;
+	do {
+		for (int i = 0; i < 10000; ++i) x = x + i;
+		sw.lap();
+	} while (sw.watch() < s);
+}
+
+TEST_CASE( "CPU time clocks", "[CpuStopWatch]" ) {
+
+	SECTION("CPU bound") {
+		CpuStopWatch sw;
+		spin(0.05);
+		sw.lap();
+		REQUIRE(sw.threadTime() >= 0.05);
+		REQUIRE(sw.threadTime() <= sw.watch() * 1.01);
+		REQUIRE(sw.processTime() >= sw.threadTime());
+		REQUIRE(sw.userTime() + sw.sysTime() == Approx(sw.threadTime()).margin(0.02));
+	}
+
+	SECTION("Waiting") {
+		CpuStopWatch sw;
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		sw.lap();
+		CpuTimes t = sw.times();
+		REQUIRE(t.wall >= 0.05);
+		REQUIRE(t.thread < 0.01);
+	}
+
+	SECTION("Other threads") {
+		CpuStopWatch sw;
+		std::thread worker([] { spin(0.05); });
+		worker.join();
+		sw.lap();
+		REQUIRE(sw.threadTime() < 0.01);
+		REQUIRE(sw.processTime() >= 0.05);
+
+		std::stringstream out;
+		out << sw;
+		REQUIRE(out.str().find("s (thread ") != std::string::npos);
+	}
+}
@@ -0,0 +1,87 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include "../stopwatch.hpp"
+#include "../tscclock.hpp"
+
+using namespace had;
+
+TEST_CASE( "Lap recorders", "[LapHistogram]" ) {
+
+	SECTION("Histogram") {
+		LapHistogram h;
+		REQUIRE(h.quantile(0.5) == 0);
+		for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+
+		REQUIRE(h.count() == 100000);
+		REQUIRE(h.min() == 1);
+		REQUIRE(h.max() == 100000);
+		REQUIRE(h.mean() == Approx(50000.5));
+		REQUIRE(h.stddev() == Approx(28867.5).epsilon(1e-3));
+		for (double q : {0.001, 0.5, 0.9, 0.99, 0.999})
+			REQUIRE(h.quantile(q) == Approx(q * 100000).epsilon(0.008));
+		REQUIRE(h.quantile(1) == 100000);
+
+		//small values are exact
+		LapHistogram s;
+		for (uint64_t v : {3, 5, 7, 200}) s.record(v);
+		REQUIRE(s.quantile(0.5) == 5);
+		REQUIRE(s.quantile(0.75) == 7);
+
+		//huge values
+		s.record(std::numeric_limits<uint64_t>::max());
+		REQUIRE(s.quantile(1) == Approx(std::numeric_limits<uint64_t>::max()));
+
+		std::stringstream out;
+		out << h;
+		REQUIRE(out.str().find("n=100000 min=1ns max=100000ns") == 0);
+	}
+
+	SECTION("Merge threads") {
+		LapHistogram all, h[4];
+		std::vector<std::thread> pool;
+		for (int t = 0; t < 4; ++t)
+			pool.emplace_back([&h, t] { for (uint64_t v = 0; v < 1000; ++v) h[t].record(v * 4 + t); });
+		for (auto &t : pool) t.join();
+		for (auto &x : h) all.merge(x);
+
+		REQUIRE(all.count() == 4000);
+		REQUIRE(all.min() == 0);
+		REQUIRE(all.max() == 3999);
+		REQUIRE(all.quantile(0.5) == Approx(2000).epsilon(0.008));
+	}
+
+	SECTION("Ring") {
+		LapRing r(3);
+		REQUIRE(r.size() == 0);
+		for (uint64_t v = 1; v <= 5; ++v) r.record(v);
+		REQUIRE(r.size() == 3);
+		REQUIRE(r.recorded() == 5);
+		REQUIRE(r.values() == std::vector<uint64_t>{3, 4, 5});
+		REQUIRE_THROWS_AS(LapRing(0), std::invalid_argument);
+	}
+
+	SECTION("StopWatch recording") {
+		LapHistogram h;
+		LapRing r(16);
+		TscStopWatch sw;
+		sw.record(&h, &r);
+		for (int i = 0; i < 10; ++i) {
+			sw.reset();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			sw.lap();
+		}
+		REQUIRE(h.count() == 10);
+		REQUIRE(r.size() == 10);
+		REQUIRE(h.min() >= 100000);
+		REQUIRE(r[9] == Approx(sw.watch() * 1e9).margin(1));
+
+		sw.record(nullptr);
+		sw.reset().lap();
+		REQUIRE(h.count() == 10);
+	}
+}
@@ -0,0 +1,60 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../stopwatch.hpp"
+
+using namespace had;
+
+TEST_CASE( "Performance counters", "[PerfCounters]" ) {
+	PerfCounters pc;
+	//perf_event_open may be forbidden altogether
+	if (!pc.available(PerfCounters::pageFaults)) {
+		WARN("perf_event_open not available");
+		return;
+	}
+
+	SECTION("Software events") {
+		StopWatch sw;
+		sw.count(&pc).reset();
+		//touch fresh pages
+		std::vector<char> *mem = new std::vector<char>(64 << 20, 1);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		sw.lap();
+		delete mem;
+		REQUIRE(pc[PerfCounters::pageFaults] >= 100);
+		REQUIRE(pc[PerfCounters::contextSwitches] >= 1);
+
+		//counts only cover last reset() to lap()
+		sw.reset().lap();
+		REQUIRE(pc[PerfCounters::pageFaults] < 100);
+	}
+
+	SECTION("Hardware events") {
+		if (!pc.hardware()) {
+			WARN("hardware counters not available, software events only");
+			REQUIRE(pc[PerfCounters::cycles] == 0);
+			REQUIRE(pc.ipc() == 0);
+			return;
+		}
+		volatile uint64_t x = 0;
+		pc.reset();
+		for (int i = 0; i < 1000000; ++i) x = x + i;
+		pc.lap();
+		REQUIRE(pc[PerfCounters::instructions] >= 1000000);
+		REQUIRE(pc[PerfCounters::cycles] > 0);
+		REQUIRE(pc.ipc() > 0);
+	}
+
+	SECTION("Print") {
+		pc.reset().lap();
+		std::stringstream out;
+		out << pc;
+		REQUIRE(out.str().find("page-faults=") != std::string::npos);
+		REQUIRE((out.str().find("IPC=") != std::string::npos) == pc.hardware());
+	}
+}
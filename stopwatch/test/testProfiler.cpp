@@ -0,0 +1,149 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../profiler.hpp"
+
+using namespace had;
+
+static void sleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+static void leaf() {
+	HAD_PROFILE_SCOPE("leaf");
+	sleepMs(2);
+}
+
+static void outer() {
+	HAD_PROFILE_SCOPE("outer");
+	sleepMs(2);
+	leaf();
+	leaf();
+}
+
+TEST_CASE( "Scoped profiler", "[Profiler]" ) {
+	Profiler &p = Profiler::instance();
+
+	SECTION("Call tree") {
+		outer();
+		outer();
+		p.collect();
+
+		const Profiler::Node &o = *p.tree().children.at("outer");
+		const Profiler::Node &l = *o.children.at("leaf");
+		REQUIRE(o.count == 2);
+		REQUIRE(l.count == 4);
+		REQUIRE(l.inclusive == Approx(l.exclusive));
+		REQUIRE(o.inclusive >= 0.012);
+		REQUIRE(o.exclusive == Approx(o.inclusive - l.inclusive));
+		REQUIRE(o.exclusive >= 0.004);
+		REQUIRE(o.exclusive < o.inclusive);
+
+		std::stringstream out;
+		p.writeReport(out);
+		REQUIRE(out.str().find("outer") != std::string::npos);
+		REQUIRE(out.str().find("  leaf") != std::string::npos);
+	}
+
+	SECTION("Threads and Chrome trace") {
+		p.tracingEnabled(true);
+		std::thread t1([] { HAD_PROFILE_SCOPE("thread \"zone\""); sleepMs(1); });
+		std::thread t2([] { HAD_PROFILE_SCOPE("thread \"zone\""); sleepMs(1); });
+		t1.join();
+		t2.join();
+		//buffers outlive their threads
+		p.collect();
+		p.tracingEnabled(false);
+		REQUIRE(p.tree().children.at("thread \"zone\"")->count == 2);
+
+		std::stringstream out;
+		p.writeChromeTrace(out);
+		const std::string json = out.str();
+		REQUIRE(json.rfind("{\"traceEvents\":[", 0) == 0);
+		REQUIRE(json.find("\"name\":\"thread \\\"zone\\\"\",\"ph\":\"X\"") != std::string::npos);
+		REQUIRE(json.find("\"dur\":") != std::string::npos);
+	}
+
+	SECTION("Collect while zones are open") {
+		{
+			HAD_PROFILE_SCOPE("open");
+			{ HAD_PROFILE_SCOPE("closed"); }
+			p.collect();
+			REQUIRE(p.tree().children.at("open")->count == 0);
+			REQUIRE(p.tree().children.at("open")->children.at("closed")->count == 1);
+		}
+		p.collect();
+		REQUIRE(p.tree().children.at("open")->count == 1);
+	}
+
+	SECTION("Background collector") {
+		p.startCollector(std::chrono::milliseconds(1));
+		std::thread t([] {
+			for (int i = 0; i < 100000; ++i) { HAD_PROFILE_SCOPE("busy"); }
+		});
+		t.join();
+		p.stopCollector();
+		REQUIRE(p.tree().children.at("busy")->count + p.dropped() >= 100000);
+	}
+
+	SECTION("Buffers of finished threads are freed") {
+		p.collect();
+		const size_t before = p.buffers();
+		for (int round = 0; round < 10; ++round) {
+			std::vector<std::thread> pool;
+			for (int i = 0; i < 20; ++i)
+				pool.emplace_back([] { HAD_PROFILE_SCOPE("short lived"); });
+			for (auto &t : pool) t.join();
+			REQUIRE(p.buffers() >= before + 20);
+			p.collect();
+			REQUIRE(p.buffers() == before);
+		}
+		REQUIRE(p.tree().children.at("short lived")->count == 200);
+
+		//running thread keeps its buffer
+		std::atomic<bool> stop{false};
+		std::thread running([&stop] {
+			{ HAD_PROFILE_SCOPE("running"); }
+			while (!stop) sleepMs(1);
+		});
+		while (p.buffers() == before) sleepMs(1);
+		p.collect();
+		REQUIRE(p.buffers() == before + 1);
+		stop = true;
+		running.join();
+		p.collect();
+		REQUIRE(p.buffers() == before);
+	}
+
+	SECTION("Report keeps stream format") {
+		std::stringstream out;
+		out << std::setprecision(2);
+		const auto flags = out.flags();
+		p.writeReport(out);
+		p.writeChromeTrace(out);
+		REQUIRE(out.flags() == flags);
+		REQUIRE(out.precision() == 2);
+	}
+
+	SECTION("Full buffer drops whole zones") {
+		p.bufferCapacity(8);
+		std::thread t([] {
+			HAD_PROFILE_SCOPE("full");
+			for (int i = 0; i < 10; ++i) { HAD_PROFILE_SCOPE("full child"); }
+		});
+		t.join();
+		p.bufferCapacity(1 << 16);
+		const uint64_t before = p.dropped();
+		p.collect();
+		const Profiler::Node &f = *p.tree().children.at("full");
+		REQUIRE(f.count == 1);
+		REQUIRE(f.children.at("full child")->count == 3);
+		REQUIRE(before >= 7);
+		REQUIRE_THROWS_AS(p.bufferCapacity(6), std::invalid_argument);
+	}
+}
@@ -0,0 +1,118 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include "../regression.hpp"
+
+using namespace had;
+
+static vector<double> noisy(double median, double noise, int n, unsigned seed) {
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> dist(median, noise);
+	vector<double> v(n);
+	for (double &x : v) x = dist(gen);
+	return v;
+}
+
+TEST_CASE( "Benchmark regression detection", "[Regression]" ) {
+
+	SECTION("Mann-Whitney U") {
+		//completely separated samples of 10: exact two sided p = 2 / C(20,10) = 1.08e-5
+		vector<double> a = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+		vector<double> b = { 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+		REQUIRE(Regression::mannWhitney(a, b) < 1e-3);
+		REQUIRE(Regression::mannWhitney(a, b) == Approx(Regression::mannWhitney(b, a)));
+		REQUIRE(Regression::mannWhitney(a, a) == Approx(1));
+		REQUIRE(Regression::mannWhitney({ 5, 5, 5 }, { 5, 5, 5 }) == 1);
+		REQUIRE(Regression::mannWhitney(noisy(100, 5, 15, 1), noisy(100, 5, 15, 2)) > 0.01);
+	}
+
+	SECTION("Verdicts") {
+		Baseline base, cur;
+		base.add("same", noisy(100, 2, 15, 1)).add("slower", noisy(100, 2, 15, 2))
+			.add("faster", noisy(100, 2, 15, 3)).add("tiny", noisy(100, 0.1, 15, 4))
+			.add("noisy", noisy(100, 30, 15, 5)).add("gone", noisy(100, 2, 15, 6));
+		cur.add("same", noisy(100, 2, 15, 7)).add("slower", noisy(120, 2, 15, 8))
+			.add("faster", noisy(80, 2, 15, 9)).add("tiny", noisy(101, 0.1, 15, 10))
+			.add("noisy", noisy(110, 30, 15, 11)).add("new", noisy(100, 2, 15, 12));
+
+		vector<Regression::Comparison> cmp = Regression(0.05, 0.01).compare(base, cur);
+		std::map<string, Regression::Verdict> v;
+		for (auto &c : cmp) v[c.name] = c.verdict;
+		REQUIRE(cmp.size() == 7);
+		REQUIRE(v["same"] == Regression::Verdict::unchanged);
+		REQUIRE(v["slower"] == Regression::Verdict::regressed);
+		REQUIRE(v["faster"] == Regression::Verdict::improved);
+		//significant but below threshold
+		REQUIRE(v["tiny"] == Regression::Verdict::unchanged);
+		//above threshold but not significant
+		REQUIRE(v["noisy"] == Regression::Verdict::unchanged);
+		REQUIRE(v["gone"] == Regression::Verdict::removed);
+		REQUIRE(v["new"] == Regression::Verdict::added);
+		REQUIRE_FALSE(Regression::passed(cmp));
+
+		std::stringstream out;
+		Regression::write(out, cmp);
+		REQUIRE(out.str().find("REGRESSED") != string::npos);
+		REQUIRE_THROWS_AS(Regression(0.05, 0), std::invalid_argument);
+	}
+
+	SECTION("Baseline file") {
+		Baseline b;
+		b.add("a b", { 1.5, 2.25, 3 }).add("c", { 10 });
+		std::stringstream file;
+		b.save(file);
+		Baseline l = Baseline::load(file);
+		REQUIRE(l.size() == 2);
+		REQUIRE(l["a b"].samples == vector<double>{ 1.5, 2.25, 3 });
+		REQUIRE(l["a b"].median == 2.25);
+		REQUIRE(l["c"].mad == 0);
+
+		std::stringstream bad("not a baseline\n");
+		REQUIRE_THROWS_AS(Baseline::load(bad), std::runtime_error);
+		std::stringstream truncated("#had benchmark baseline v1\nx\t1\t0\t3\t1\t1\n");
+		REQUIRE_THROWS_AS(Baseline::load(truncated), std::runtime_error);
+		REQUIRE_THROWS_AS(b.add("tab\tname", { 1 }), std::invalid_argument);
+	}
+
+	SECTION("Check benchmarks against baseline file") {
+		const string path = "testRegression.baseline";
+		std::remove(path.c_str());
+		Benchmark::Options opt;
+		opt.warmup = opt.minTime = 0.002;
+		Benchmark bench(opt);
+		bench.run("sum", [] {
+			uint64_t s = 0;
+			for (int i = 0; i < 1000; ++i) s += i;
+			doNotOptimize(s);
+		});
+		std::stringstream report;
+		Regression loose(10, 0.01);
+		REQUIRE(loose.check(bench, path, report));
+		REQUIRE(report.str().find("Baseline saved") != string::npos);
+		REQUIRE(loose.check(bench, path, report));
+		REQUIRE(report.str().find("unchanged") != string::npos);
+		std::remove(path.c_str());
+	}
+
+	SECTION("stream format is restored") {
+		Baseline b;
+		b.add("x", { 1.5, 2.5 });
+		const vector<Regression::Comparison> cmp = Regression().compare(b, b);
+
+		std::stringstream os;
+		os << std::setprecision(3);
+		const auto flags = os.flags();
+		b.save(os);
+		Regression::write(os, cmp);
+		REQUIRE(os.flags() == flags);
+		REQUIRE(os.precision() == 3);
+		os.str("");
+		os << 1.23456789;
+		REQUIRE(os.str() == "1.23");
+	}
+}
@@ -0,0 +1,116 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// Link with -rdynamic, so functions of the test have names
+//
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <appTest/AppTest.hpp>
+#include "../cpuclock.hpp"
+#include "../sampler.hpp"
+
+using namespace had;
+
+__attribute__((noinline)) uint64_t samplerHotLoop(double s) {
+	BasicStopWatch<ThreadCpuClock> sw;
+	volatile uint64_t x = 0;
+	do {
+		for (int i = 0; i < 1000000; ++i) x = x + i;
+		sw.lap();
+	} while (sw.watch() < s);
+	return x;
+}
+
+__attribute__((noinline)) uint64_t samplerCaller(double s) {
+	return samplerHotLoop(s) + 1;
+}
+
+__attribute__((noinline)) int samplerStudentMain(int, char **, std::istream &, std::ostream &out) {
+	out << samplerCaller(0.1);
+	return 0;
+}
+
+TEST_CASE( "Sampling profiler", "[Sampler]" ) {
+
+	SECTION("Samples CPU time of calling thread") {
+		Sampler sampler(std::chrono::microseconds(500));
+		AppTest apptest;
+		sampler.start();
+		apptest.exec(samplerStudentMain, { "student" });
+		sampler.stop();
+
+		//0.1s of CPU at 0.5ms: at most about 200 samples, less with coarse kernel ticks
+		REQUIRE(sampler.count() >= 10);
+		REQUIRE(sampler.count() <= 250);
+		REQUIRE(sampler.dropped() == 0);
+
+		std::stringstream folded;
+		sampler.writeFolded(folded);
+		const string f = folded.str();
+		REQUIRE(f.find("samplerStudentMain(int, char**, std::istream&, std::ostream&);samplerCaller(double);samplerHotLoop(double)") != string::npos);
+
+		std::stringstream top;
+		sampler.writeTop(top, 3);
+		REQUIRE(top.str().find("samplerHotLoop(double)") != string::npos);
+
+		sampler.clear();
+		REQUIRE(sampler.count() == 0);
+	}
+
+	SECTION("Waiting is not sampled") {
+		Sampler sampler;
+		sampler.start();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		sampler.stop();
+		REQUIRE(sampler.count() <= 2);
+	}
+
+	SECTION("Several threads, full ring") {
+		Sampler sampler(std::chrono::microseconds(200), 16);
+		auto work = [&sampler] {
+			sampler.start();
+			samplerHotLoop(0.05);
+			sampler.stop();
+		};
+		std::thread t1(work), t2(work);
+		t1.join();
+		t2.join();
+		REQUIRE(sampler.count() == 16);
+		REQUIRE(sampler.dropped() > 0);
+	}
+
+	SECTION("Destroyed while other threads are sampled") {
+		for (int round = 0; round < 20; ++round) {
+			Sampler *sampler = new Sampler(std::chrono::microseconds(50), 64);
+			std::atomic<int> started{0};
+			std::atomic<bool> done{false};
+			auto work = [&] {
+				sampler->start();
+				++started;
+				volatile uint64_t x = 0;
+				while (!done) x = x + 1;
+			};
+			std::thread t1(work), t2(work);
+			while (started < 2) std::this_thread::yield();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			delete sampler;
+			done = true;
+			t1.join();
+			t2.join();
+		}
+		Sampler after;
+		after.start().stop();
+	}
+
+	SECTION("One Sampler at a time") {
+		Sampler a, b;
+		a.start();
+		REQUIRE_THROWS_AS(b.start(), std::logic_error);
+		a.stop();
+		b.start().stop();
+		REQUIRE_THROWS_AS(Sampler(std::chrono::microseconds(0)), std::invalid_argument);
+	}
+}
@@ -2,25 +2,35 @@
 	StopWatch class simple test and demo
 	v2.0 hdaniel@ualg.pt 2011
 	v2.1 hdaniel@ualg.pt 2019 apr
+	v2.2 hdaniel@ualg.pt 2026 oct
 	Changelog:
  		full c++ implementation
+ 		TscStopWatch demo
 */
 
 #include <iostream>
 #include "stopwatch.hpp"
+#include "tscclock.hpp"
 
 using namespace std;
 using namespace had;
 
 int main (int argc, char** argv) {
 StopWatch sw;
+TscStopWatch tsw;
 
 	sw.reset();
+	tsw.reset();
 	for (int i=0; i<1000000; i++)
 		cout << i << endl;
+	tsw.lap();
 	sw.lap();
 
-	cout << sw << endl;	
+	cout << sw << endl;
+	cout << tsw << " (invariant TSC: " << TscClock::invariantTsc()
+		 << ", " << TscClock::frequency() / 1e9 << " GHz)" << endl;
+	cout << "overhead: " << StopWatch::overhead() * 1e9 << "ns, TSC overhead: "
+		 << TscStopWatch::overhead() * 1e9 << "ns" << endl;
 
 	return 0;
 }
@@ -0,0 +1,122 @@
+/**
+ * Time Stamp Counter clock for StopWatch
+ * v1.0 hdaniel@ualg.pt 2026 oct
+ *
+ * Reads the x86 TSC with rdtscp followed by lfence, so the read waits for
+ * previous instructions and later instructions do not start before it.
+ * Only used if the CPU reports an invariant TSC (constant rate, not stopped
+ * in sleep states), otherwise falls back to clock_gettime(CLOCK_MONOTONIC_RAW)
+ * in nanoseconds.
+ *
+ * TSC frequency is calibrated against steady_clock once, on the first
+ * conversion to seconds, so reading time stamps never waits for calibration.
+ *
+ * Use it as:
+ *     TscStopWatch sw;
+ *     //...
+ *     sw.lap();
+ *     cout << sw.watch() - TscStopWatch::overhead();
+ */
+
+#ifndef __HAD_TSCCLOCK_HPP__
+#define __HAD_TSCCLOCK_HPP__
+
+#include <chrono>
+#include <cstdint>
+#include <time.h>
+#include "stopwatch.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define __HAD_TSC_AVAILABLE__
+#endif
+
+namespace had {
+
+	class TscClock {
+
+		/**
+		 * @return true if CPU has rdtscp and invariant TSC
+		 */
+		static bool detect() {
+#ifdef __HAD_TSC_AVAILABLE__
+			unsigned eax, ebx, ecx, edx;
+			if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) return false;
+			__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+			const bool rdtscp = edx & (1u << 27);
+			__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+			const bool invariant = edx & (1u << 8);
+			return rdtscp && invariant;
+#else
+			return false;
+#endif
+		}
+
+		static uint64_t monotonicRaw() {
+			timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+			clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+			return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+		}
+
+		/**
+		 * Counts TSC ticks during ~20ms of steady_clock
+		 *
+		 * @return ticks per second
+		 */
+		static double calibrate() {
+			if (!useTsc) return 1e9;
+			const auto t0 = steady_clock::now();
+			const uint64_t c0 = now();
+			auto t1 = t0;
+			while (t1 - t0 < milliseconds(20)) t1 = steady_clock::now();
+			const uint64_t c1 = now();
+			return (c1 - c0) / duration<double>(t1 - t0).count();
+		}
+
+		//read at static initialization (cpuid only, no calibration)
+		static inline const bool useTsc = detect();
+
+	public:
+		typedef uint64_t ticks;
+
+		/**
+		 * @return TSC value if invariant TSC, CLOCK_MONOTONIC_RAW nanoseconds otherwise
+		 */
+		static ticks now() {
+#ifdef __HAD_TSC_AVAILABLE__
+			if (useTsc) {
+				unsigned aux;
+				const uint64_t t = __rdtscp(&aux);
+				_mm_lfence();
+				return t;
+			}
+#endif
+			return monotonicRaw();
+		}
+
+		/**
+		 * @return true if ticks are read from an invariant TSC
+		 */
+		static bool invariantTsc() { return useTsc; }
+
+		/**
+		 * @return ticks per second, calibrated on first call
+		 */
+		static double frequency() {
+			static const double f = calibrate();
+			return f;
+		}
+
+		static double toSeconds(ticks t) { return t / frequency(); }
+	};
+
+	typedef BasicStopWatch<TscClock> TscStopWatch;
+
+}
+
+#endif //__HAD_TSCCLOCK_HPP__
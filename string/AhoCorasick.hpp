@@ -0,0 +1,437 @@
+/**
+ * Aho-Corasick multi-pattern search
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Finds all occurrences of a set of patterns in a single pass over the
+ * text, instead of one search per pattern:
+ *   - the automaton is a DFA: one table lookup per byte, no failure links
+ *     are followed while searching
+ *   - the alphabet is compressed: bytes that are not in any pattern share
+ *     one class, so rows are only as wide as the distinct bytes of the
+ *     patterns and the table stays small enough for the cache
+ *   - transitions are premultiplied row offsets, and a high bit marks
+ *     states where patterns end
+ *   - in the start state, bytes that cannot start a pattern are skipped
+ *     16 or 32 at a time (SSSE3 / AVX2 nibble lookup), a DFA step is only
+ *     done from the first byte that can
+ *   - Stream keeps the state between chunks, so patterns crossing chunk
+ *     boundaries are found, with positions relative to the whole input
+ *   - non overlapping matches are selected while scanning: a match is
+ *     decided once no match can start at or before it, i.e. the text
+ *     matched by the state (its depth) starts after it, so only matches
+ *     within one pattern length of the scan are kept
+ *
+ * Use it as:
+ *     AhoCorasick banned({ "password", "secret", "token" });
+ *     string clean = banned.replace(output, "***");
+ *     for (auto &m : banned.findAll(text)) ... text.substr(m.position, m.length)
+ *
+ * Ref: Aho, Corasick, "Efficient string matching: an aid to bibliographic search", 1975
+ */
+
+#ifndef __HAD_AHOCORASICK_HPP__
+#define __HAD_AHOCORASICK_HPP__
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace had {
+
+	class AhoCorasick {
+	public:
+		struct Match {
+			size_t position;        //of first byte in text
+			size_t length;
+			uint32_t pattern;       //index in patterns of constructor
+
+			bool operator==(const Match &) const = default;
+		};
+
+	private:
+		static constexpr uint32_t matchBit = 0x80000000u;
+
+		vector<string> patterns_;
+		std::array<uint16_t, 256> classOf{};     //0: bytes of no pattern
+		uint32_t classes = 1;
+		vector<uint32_t> delta;                   //row offset of next state | matchBit
+		vector<uint32_t> outFirst;                //patterns ending at state s: outputs[outFirst[s], outFirst[s + 1])
+		vector<uint32_t> outputs;
+		vector<uint32_t> depth;                   //length of the prefix matched at each state
+		size_t maxLength = 1;                     //of patterns
+
+		//bytes that leave the start state
+		std::array<bool, 256> starts{};
+		//nibble tables: byte b can start a pattern if lowNibble[b & 15] & highNibble[b >> 4],
+		//bit min(b >> 4, 7) of lowNibble, high bytes share bit 7 (false positives are only slower)
+		alignas(16) std::array<uint8_t, 16> lowNibble{};
+		alignas(16) std::array<uint8_t, 16> highNibble{};
+		bool skip = false;
+
+		/**
+		 * @return first position >= i of a byte that can start a pattern, n if none
+		 */
+		size_t skipStart(const char *p, size_t i, size_t n) const {
+#if defined(__AVX2__)
+			const __m256i low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(lowNibble.data())));
+			const __m256i high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(highNibble.data())));
+			const __m256i mask4 = _mm256_set1_epi8(0x0F);
+			for (; i + 32 <= n; i += 32) {
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+				const __m256i lo = _mm256_shuffle_epi8(low, _mm256_and_si256(v, mask4));
+				const __m256i hi = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask4));
+				const __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+				const uint32_t candidates = ~static_cast<uint32_t>(_mm256_movemask_epi8(none));
+				if (candidates) return i + std::countr_zero(candidates);
+			}
+#endif
+#if defined(__SSSE3__)
+			const __m128i low16 = _mm_load_si128(reinterpret_cast<const __m128i *>(lowNibble.data()));
+			const __m128i high16 = _mm_load_si128(reinterpret_cast<const __m128i *>(highNibble.data()));
+			const __m128i mask16 = _mm_set1_epi8(0x0F);
+			for (; i + 16 <= n; i += 16) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+				const __m128i lo = _mm_shuffle_epi8(low16, _mm_and_si128(v, mask16));
+				const __m128i hi = _mm_shuffle_epi8(high16, _mm_and_si128(_mm_srli_epi16(v, 4), mask16));
+				const __m128i none = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+				const uint32_t candidates = ~static_cast<uint32_t>(_mm_movemask_epi8(none)) & 0xFFFF;
+				if (candidates) return i + std::countr_zero(candidates);
+			}
+#endif
+			while (i < n && !starts[static_cast<uint8_t>(p[i])]) ++i;
+			return i;
+		}
+
+		/**
+		 * Reports patterns ending at state
+		 * @return false if on asked to stop
+		 */
+		template<class F>
+		bool report(uint32_t state, size_t end, F &on) const {
+			const uint32_t s = state / classes;
+			for (uint32_t k = outFirst[s]; k < outFirst[s + 1]; ++k) {
+				const uint32_t id = outputs[k];
+				const Match m { end - patterns_[id].size(), patterns_[id].size(), id };
+				if constexpr (std::is_same_v<decltype(on(m)), bool>) {
+					if (!on(m)) return false;
+				} else on(m);
+			}
+			return true;
+		}
+
+		/**
+		 * Runs the DFA over p[0, n) from state
+		 *
+		 * @param base position of p[0] in the whole input
+		 * @return false if on asked to stop
+		 */
+		template<class F>
+		bool run(const char *p, size_t n, uint32_t &state, size_t base, F &on) const {
+			const uint32_t *d = delta.data();
+			for (size_t i = 0; i < n; ++i) {
+				if (state == 0 && skip) {
+					i = skipStart(p, i, n);
+					if (i == n) break;
+				}
+				const uint32_t next = d[state + classOf[static_cast<uint8_t>(p[i])]];
+				state = next & ~matchBit;
+				if ((next & matchBit) && !report(state, base + i + 1, on)) return false;
+			}
+			return true;
+		}
+
+	public:
+
+		/**
+		 * Streaming search: text is given in chunks, matches that cross
+		 * chunk boundaries are found
+		 */
+		class Stream {
+			const AhoCorasick *ac;
+			uint32_t state = 0;
+			size_t offset = 0;
+			bool stopped_ = false;
+
+		public:
+			explicit Stream(const AhoCorasick &ac) : ac(&ac) { }
+
+			/**
+			 * @param chunk next bytes of input
+			 * @param on    called with each Match, positions relative to the
+			 *              start of the input, may return false to stop:
+			 *              the stream stops, next chunks are not searched
+			 *              until reset()
+			 * @return false if the stream is stopped
+			 */
+			template<class F>
+			bool feed(string_view chunk, F &&on) {
+				if (!stopped_) stopped_ = !ac->run(chunk.data(), chunk.size(), state, offset, on);
+				offset += chunk.size();
+				return !stopped_;
+			}
+
+			/**
+			 * @return bytes fed since construction or reset, searched or not
+			 */
+			size_t position() const { return offset; }
+
+			/**
+			 * @return true if a callback returned false
+			 */
+			bool stopped() const { return stopped_; }
+
+			void reset() {
+				state = 0;
+				offset = 0;
+				stopped_ = false;
+			}
+		};
+
+		/**
+		 * @param patterns to search, not empty, may contain any bytes
+		 * @throws invalid_argument if a pattern is empty
+		 * @throws length_error if the automaton does not fit 32 bit offsets
+		 */
+		explicit AhoCorasick(const vector<string> &patterns) : patterns_(patterns) {
+			for (const string &p : patterns_) {
+				if (p.empty()) throw std::invalid_argument("AhoCorasick: empty pattern");
+				maxLength = std::max(maxLength, p.size());
+				for (unsigned char c : p)
+					if (!classOf[c]) classOf[c] = classes++;
+			}
+
+			//trie, 0 is the root and also "no edge"
+			delta.assign(classes, 0);
+			depth.assign(1, 0);
+			vector<vector<uint32_t>> own(1);
+			for (uint32_t id = 0; id < patterns_.size(); ++id) {
+				uint32_t s = 0;
+				for (unsigned char c : patterns_[id]) {
+					uint32_t &t = delta[s * classes + classOf[c]];
+					if (!t) {
+						t = own.size();
+						own.emplace_back();
+						depth.push_back(depth[s] + 1);
+						delta.resize(delta.size() + classes, 0);
+					}
+					s = delta[s * classes + classOf[c]];
+				}
+				own[s].push_back(id);
+			}
+			const size_t states = own.size();
+			if (states * classes >= matchBit) throw std::length_error("AhoCorasick: too many states");
+
+			//failure links in BFS order complete the DFA, outputs of a state
+			//include the outputs of its failure state
+			vector<uint32_t> fail(states, 0), order;
+			order.reserve(states);
+			order.push_back(0);
+			for (size_t q = 0; q < order.size(); ++q) {
+				const uint32_t s = order[q];
+				for (uint32_t c = 0; c < classes; ++c) {
+					uint32_t &t = delta[s * classes + c];
+					const uint32_t viaFail = s ? delta[fail[s] * classes + c] : 0;
+					if (t) {
+						fail[t] = viaFail;
+						order.push_back(t);
+					} else t = viaFail;
+				}
+			}
+			outFirst.assign(states + 1, 0);
+			vector<vector<uint32_t>> out(states);
+			for (uint32_t s : order) {
+				out[s] = own[s];
+				if (s) out[s].insert(out[s].end(), out[fail[s]].begin(), out[fail[s]].end());
+			}
+			for (size_t s = 0; s < states; ++s) {
+				outFirst[s + 1] = outFirst[s] + out[s].size();
+				outputs.insert(outputs.end(), out[s].begin(), out[s].end());
+			}
+
+			//premultiplied rows with match bits
+			for (uint32_t &t : delta)
+				t = t * classes | (outFirst[t + 1] != outFirst[t] ? matchBit : 0);
+
+			size_t startBytes = 0;
+			for (int b = 0; b < 256; ++b) {
+				if (classOf[b] && delta[classOf[b]] != 0) {
+					starts[b] = true;
+					++startBytes;
+					lowNibble[b & 15] |= 1 << std::min(b >> 4, 7);
+				}
+			}
+			for (int h = 0; h < 16; ++h) highNibble[h] = 1 << std::min(h, 7);
+			//with many start bytes most positions are candidates, skipping does not pay
+			skip = startBytes <= 32;
+		}
+
+		/**
+		 * @return number of patterns
+		 */
+		size_t size() const { return patterns_.size(); }
+
+		/**
+		 * @return number of DFA states
+		 */
+		size_t states() const { return outFirst.size() - 1; }
+
+		const string &pattern(uint32_t i) const { return patterns_[i]; }
+
+		/**
+		 * Calls on(Match) for each occurrence of each pattern, overlapping
+		 * occurrences included, in order of their end in text
+		 *
+		 * @param on may return false to stop
+		 */
+		template<class F>
+		void scan(string_view text, F &&on) const {
+			uint32_t state = 0;
+			run(text.data(), text.size(), state, 0, on);
+		}
+
+		/**
+		 * @return all occurrences of all patterns, in order of their end in text
+		 */
+		vector<Match> findAll(string_view text) const {
+			vector<Match> ret;
+			scan(text, [&ret](const Match &m) { ret.push_back(m); });
+			return ret;
+		}
+
+		/**
+		 * @return true if text contains any pattern, stops at the first
+		 */
+		bool contains(string_view text) const {
+			bool found = false;
+			scan(text, [&found](const Match &) { return !(found = true); });
+			return found;
+		}
+
+		/**
+		 * Calls on(Match) for occurrences that do not overlap, in order:
+		 * leftmost first and, of those starting at the same position, the longest.
+		 * Selected while scanning, memory is bounded by the longest pattern
+		 */
+		template<class F>
+		void scanNonOverlapping(string_view text, F &&on) const {
+			//undecided matches, the longest of each position p in slot p % window:
+			//undecided positions are within the text matched by the state, at most the longest pattern
+			const size_t window = maxLength;
+			vector<Match> slots(window, Match { 0, 0, 0 });
+			size_t pending = 0;     //undecided matches
+			size_t first = 0;       //first undecided position
+			size_t end = 0;         //of last match selected
+			//decides matches before windowStart: no other match can start before it
+			auto decide = [&](size_t windowStart) {
+				for (; first < windowStart && pending; ++first) {
+					Match &m = slots[first % window];
+					if (!m.length) continue;
+					if (m.position >= end) {
+						on(m);
+						end = m.position + m.length;
+					}
+					m.length = 0;
+					--pending;
+				}
+				first = windowStart;
+			};
+
+			const uint32_t *d = delta.data();
+			const char *p = text.data();
+			const size_t n = text.size();
+			uint32_t state = 0;
+			for (size_t i = 0; i < n; ++i) {
+				//in the start state nothing is pending: skipped bytes start no match
+				if (state == 0 && skip) {
+					i = skipStart(p, i, n);
+					if (i == n) break;
+				}
+				const uint32_t next = d[state + classOf[static_cast<uint8_t>(p[i])]];
+				state = next & ~matchBit;
+				//before adding matches of this byte, which start at windowStart or later
+				if (pending) {
+					const size_t windowStart = i + 1 - depth[state / classes];
+					if (first < windowStart) decide(windowStart);
+				}
+				if (next & matchBit) {
+					const uint32_t s = state / classes;
+					if (!pending) first = i + 1 - depth[s];
+					for (uint32_t k = outFirst[s]; k < outFirst[s + 1]; ++k) {
+						const size_t length = patterns_[outputs[k]].size();
+						const size_t position = i + 1 - length;
+						if (position < end) continue;
+						Match &m = slots[position % window];
+						if (!m.length) ++pending;
+						if (m.length < length) m = { position, length, outputs[k] };
+					}
+				}
+			}
+			decide(n);
+		}
+
+		/**
+		 * @return occurrences that do not overlap, leftmost first and,
+		 *         of those starting at the same position, the longest
+		 */
+		vector<Match> findNonOverlapping(string_view text) const {
+			vector<Match> ret;
+			scanNonOverlapping(text, [&ret](const Match &m) { ret.push_back(m); });
+			return ret;
+		}
+
+		/**
+		 * @param replacements replacement of each pattern, same size as patterns
+		 * @return text with non overlapping occurrences (findNonOverlapping()) replaced
+		 */
+		string replace(string_view text, const vector<string> &replacements) const {
+			if (replacements.size() != patterns_.size())
+				throw std::invalid_argument("AhoCorasick: one replacement per pattern");
+			string ret;
+			ret.reserve(text.size());
+			size_t last = 0;
+			scanNonOverlapping(text, [&](const Match &m) {
+				ret.append(text, last, m.position - last);
+				ret.append(replacements[m.pattern]);
+				last = m.position + m.length;
+			});
+			ret.append(text, last);
+			return ret;
+		}
+
+		/**
+		 * @return text with non overlapping occurrences of all patterns replaced by replacement
+		 */
+		string replace(string_view text, string_view replacement) const {
+			string ret;
+			ret.reserve(text.size());
+			size_t last = 0;
+			scanNonOverlapping(text, [&](const Match &m) {
+				ret.append(text, last, m.position - last);
+				ret.append(replacement);
+				last = m.position + m.length;
+			});
+			ret.append(text, last);
+			return ret;
+		}
+
+		Stream stream() const { return Stream(*this); }
+	};
+
+}
+
+#endif //__HAD_AHOCORASICK_HPP__
@@ -0,0 +1,344 @@
+/**
+ * Random generators
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Fast generators for test data and fuzz input, instead of std::rand
+ * (one global state, not thread safe, 31 bits of low quality):
+ *   - Xoshiro256pp: xoshiro256++, 64 bits per call, 256 bits of state,
+ *     jump() advances 2^128 calls for non overlapping streams
+ *   - Philox4x32: Philox4x32-10, counter based: output n of stream s
+ *     depends only on (seed, s, n), so parallel runs are reproducible
+ *     whatever the number of threads and the order of work
+ *   - Random: 4 xoshiro256++ streams in lanes, advanced together by loops
+ *     the compiler vectorizes, fills buffers in bulk.
+ *     Random::local() is a different stream in each thread, seeded by
+ *     a splitmix64 hash of a thread counter.
+ *
+ * All are UniformRandomBitGenerators, usable with std distributions.
+ *
+ * randomFill() maps random bits to characters of any alphabet without
+ * rejection: 32 random bits x per character, index (x * size) >> 32.
+ * The bias is below size / 2^32, e.g. 1.4e-8 for 62 characters.
+ *
+ * Ref: Blackman, Vigna, "Scrambled linear pseudorandom number generators", 2021
+ *      Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011
+ */
+
+#ifndef __HAD_RANDOM_HPP__
+#define __HAD_RANDOM_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using std::string;
+using std::string_view;
+
+namespace had {
+
+	//seeds generators: every seed, 0 included, gives a well mixed state
+	inline uint64_t splitmix64(uint64_t &x) {
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+
+	class Xoshiro256pp {
+		uint64_t s[4];
+
+		static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+		friend class Random;
+
+	public:
+		typedef uint64_t result_type;
+
+		explicit Xoshiro256pp(uint64_t seed = 0) {
+			for (uint64_t &x : s) x = splitmix64(seed);
+		}
+
+		/**
+		 * @param state initial state, not all zero
+		 */
+		explicit Xoshiro256pp(const uint64_t (&state)[4]) {
+			std::memcpy(s, state, sizeof(s));
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+		result_type operator()() {
+			const uint64_t ret = rotl(s[0] + s[3], 23) + s[0];
+			const uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+			return ret;
+		}
+
+		/**
+		 * Advances 2^128 calls: 2^128 non overlapping streams of 2^128 numbers
+		 */
+		void jump() {
+			static constexpr uint64_t poly[] = {
+					0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+			uint64_t j[4] = { 0, 0, 0, 0 };
+			for (uint64_t p : poly)
+				for (int b = 0; b < 64; ++b) {
+					if (p & (1ull << b))
+						for (int i = 0; i < 4; ++i) j[i] ^= s[i];
+					(*this)();
+				}
+			std::memcpy(s, j, sizeof(s));
+		}
+	};
+
+
+	class Philox4x32 {
+		uint32_t key[2];
+		uint32_t ctr[4];
+		uint32_t out[4];
+		int used = 4;           //words of out already returned
+
+		static void round(uint32_t c[4], const uint32_t k[2]) {
+			const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+			const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+			const uint32_t r[4] = {
+					static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<uint32_t>(p1),
+					static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<uint32_t>(p0) };
+			std::memcpy(c, r, sizeof(r));
+		}
+
+		void block() {
+			std::memcpy(out, ctr, sizeof(out));
+			uint32_t k[2] = { key[0], key[1] };
+			for (int i = 0; i < 10; ++i) {
+				round(out, k);
+				k[0] += 0x9E3779B9u;
+				k[1] += 0xBB67AE85u;
+			}
+			//128 bit counter of blocks
+			for (int i = 0; i < 4 && ++ctr[i] == 0; ++i) { }
+			used = 0;
+		}
+
+	public:
+		typedef uint64_t result_type;
+
+		/**
+		 * @param seed   key of the generator
+		 * @param stream independent sequence of this seed, e.g. thread or task number
+		 */
+		explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0)
+				: key { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) },
+				  ctr { 0, 0, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) } { }
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+		result_type operator()() {
+			if (used == 4) block();
+			const uint64_t ret = out[used] | static_cast<uint64_t>(out[used + 1]) << 32;
+			used += 2;
+			return ret;
+		}
+
+		/**
+		 * Moves to output n of the stream, O(1)
+		 */
+		void seek(uint64_t n) {
+			ctr[0] = static_cast<uint32_t>(n / 2);
+			ctr[1] = static_cast<uint32_t>(n / 2 >> 32);
+			block();
+			used = (n % 2) * 2;
+		}
+	};
+
+
+	class Random {
+		static constexpr int lanes = 4;
+		//s[i][lane]: the same word of all lanes is contiguous, for SIMD
+		alignas(32) uint64_t s[4][lanes];
+
+		static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+		//counter of threads, hashed into the seed of each
+		static std::atomic<uint64_t> &threadSeed() {
+			static std::atomic<uint64_t> seed { 0x5EED5EED5EED5EEDull };
+			return seed;
+		}
+
+		//one xoshiro256++ step of all lanes
+		void next(uint64_t out[lanes]) {
+			for (int l = 0; l < lanes; ++l) out[l] = rotl(s[0][l] + s[3][l], 23) + s[0][l];
+			for (int l = 0; l < lanes; ++l) {
+				const uint64_t t = s[1][l] << 17;
+				s[2][l] ^= s[0][l];
+				s[3][l] ^= s[1][l];
+				s[1][l] ^= s[2][l];
+				s[0][l] ^= s[3][l];
+				s[2][l] ^= t;
+				s[3][l] = rotl(s[3][l], 45);
+			}
+		}
+
+	public:
+		typedef uint64_t result_type;
+
+		/**
+		 * Lanes are streams of one xoshiro256++, 2^128 numbers apart
+		 */
+		explicit Random(uint64_t seed = 0) {
+			Xoshiro256pp g(seed);
+			//state of lane l is the state of g after l jumps
+			for (int l = 0; l < lanes; ++l) {
+				for (int i = 0; i < 4; ++i) s[i][l] = g.s[i];
+				g.jump();
+			}
+		}
+
+		/**
+		 * @return generator of the calling thread, a different stream in each thread
+		 */
+		static Random &local() {
+			//hashed: consecutive counters seeded with splitmix64 would give
+			//states shifted by one word, as seeding also steps splitmix64
+			thread_local Random r([] {
+				uint64_t x = threadSeed().fetch_add(1);
+				return splitmix64(x);
+			}());
+			return r;
+		}
+
+		/**
+		 * Seeds the streams of threads that did not use local() yet,
+		 * streams depend on the order threads first call local()
+		 */
+		static void seedThreads(uint64_t seed) { threadSeed() = seed; }
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+		result_type operator()() {
+			uint64_t r[lanes];
+			next(r);
+			return r[0];
+		}
+
+		/**
+		 * @param out n random bytes
+		 */
+		void fill(char *out, size_t n) {
+			uint64_t r[lanes];
+			size_t i = 0;
+			for (; i + sizeof(r) <= n; i += sizeof(r)) {
+				next(r);
+				std::memcpy(out + i, r, sizeof(r));
+			}
+			if (i < n) {
+				next(r);
+				std::memcpy(out + i, r, n - i);
+			}
+		}
+
+		/**
+		 * @param out n random characters of alphabet
+		 * @throws invalid_argument if alphabet is empty
+		 */
+		void fill(char *out, size_t n, string_view alphabet) {
+			if (alphabet.empty()) throw std::invalid_argument("Random: empty alphabet");
+			const uint64_t size = alphabet.size();
+			const char *a = alphabet.data();
+			constexpr int perStep = 2 * lanes;      //32 bits per character
+			uint64_t r[lanes];
+			uint32_t idx[perStep];
+			size_t i = 0;
+			for (; i + perStep <= n; i += perStep) {
+				next(r);
+				for (int l = 0; l < lanes; ++l) {
+					idx[2 * l] = ((r[l] & 0xFFFFFFFFu) * size) >> 32;
+					idx[2 * l + 1] = ((r[l] >> 32) * size) >> 32;
+				}
+				for (int k = 0; k < perStep; ++k) out[i + k] = a[idx[k]];
+			}
+			if (i < n) {
+				next(r);
+				for (int k = 0; i < n; ++i, ++k) {
+					const uint64_t x = k % 2 ? r[k / 2] >> 32 : r[k / 2] & 0xFFFFFFFFu;
+					out[i] = a[(x * size) >> 32];
+				}
+			}
+		}
+
+		/**
+		 * @return n random characters of alphabet
+		 */
+		string str(size_t n, string_view alphabet) {
+			string ret(n, '\0');
+			fill(ret.data(), n, alphabet);
+			return ret;
+		}
+
+		/**
+		 * @return n random bytes
+		 */
+		string bytes(size_t n) {
+			string ret(n, '\0');
+			fill(ret.data(), n);
+			return ret;
+		}
+	};
+
+
+	/**
+	 * @param g   any UniformRandomBitGenerator of 64 bits, e.g. Philox4x32
+	 * @param out n random characters of alphabet
+	 */
+	template<class G>
+	void randomFill(G &g, char *out, size_t n, string_view alphabet) {
+		static_assert(G::min() == 0 && G::max() == std::numeric_limits<uint64_t>::max(),
+					  "randomFill: generator must return 64 random bits");
+		if (alphabet.empty()) throw std::invalid_argument("randomFill: empty alphabet");
+		const uint64_t size = alphabet.size();
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2) {
+			const uint64_t r = g();
+			out[i] = alphabet[((r & 0xFFFFFFFFu) * size) >> 32];
+			out[i + 1] = alphabet[((r >> 32) * size) >> 32];
+		}
+		if (i < n) out[i] = alphabet[((g() & 0xFFFFFFFFu) * size) >> 32];
+	}
+
+	/**
+	 * @param out n random bytes
+	 */
+	template<class G>
+	void randomFill(G &g, char *out, size_t n) {
+		static_assert(G::min() == 0 && G::max() == std::numeric_limits<uint64_t>::max(),
+					  "randomFill: generator must return 64 random bits");
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			const uint64_t r = g();
+			std::memcpy(out + i, &r, 8);
+		}
+		if (i < n) {
+			const uint64_t r = g();
+			std::memcpy(out + i, &r, n - i);
+		}
+	}
+
+	inline void randomFill(Random &g, char *out, size_t n, string_view alphabet) { g.fill(out, n, alphabet); }
+	inline void randomFill(Random &g, char *out, size_t n) { g.fill(out, n); }
+
+}
+
+#endif //__HAD_RANDOM_HPP__
@@ -8,25 +8,241 @@
 #ifndef __HAD_STRING_HPP
 #define __HAD_STRING_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Random.hpp"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using std::string;
+using std::string_view;
 using std::regex;
 using std::regex_search;
 using std::sregex_iterator;
+using std::vector;
 
 namespace had {
 
+	/**
+	 * Options of String::split
+	 */
+	struct SplitOptions {
+		bool skipEmpty = false;     //no empty tokens, e.g. between consecutive delimiters; an empty quoted token "" is kept
+		char quote = '\0';          //delimiters between quotes do not split, '\0' no quoting
+	};
+
 	class String {
 
-		static inline const char* alphaNum =
+		static constexpr string_view alphaNum =
 				"0123456789"
 				"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 				"abcdefghijklmnopqrstuvwxyz";
 
+		/**
+		 * Thread safe LRU cache of compiled regular expressions:
+		 * compiling a std::regex costs more than most searches with it
+		 */
+		class RegexCache {
+			typedef std::pair<string, std::shared_ptr<const regex>> Item;
+
+			std::mutex mutex;
+			size_t capacity = 64;
+			std::list<Item> items;      //most recently used first
+			std::unordered_map<string_view, std::list<Item>::iterator> index;   //views of keys in items
+
+			void trim() {
+				while (items.size() > capacity) {
+					index.erase(items.back().first);
+					items.pop_back();
+				}
+			}
+
+		public:
+			std::shared_ptr<const regex> get(const string &pattern) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					const auto it = index.find(pattern);
+					if (it != index.end()) {
+						items.splice(items.begin(), items, it->second);
+						return it->second->second;
+					}
+				}
+				//compiled outside the lock, throws regex_error if invalid
+				auto compiled = std::make_shared<const regex>(pattern);
+				std::lock_guard<std::mutex> lock(mutex);
+				const auto it = index.find(pattern);
+				if (it != index.end()) return it->second->second;   //compiled by another thread
+				items.emplace_front(pattern, compiled);
+				index.emplace(items.front().first, items.begin());
+				trim();
+				return compiled;
+			}
+
+			void resize(size_t n) {
+				std::lock_guard<std::mutex> lock(mutex);
+				capacity = n;
+				trim();
+			}
+
+			size_t size() {
+				std::lock_guard<std::mutex> lock(mutex);
+				return items.size();
+			}
+		};
+
+		static RegexCache &regexCache() {
+			static RegexCache cache;
+			return cache;
+		}
+
 	public:
 
+		/**
+		 * @param s      string to search
+		 * @param needle substring to find
+		 * @param pos    first position to search
+		 * @return position of first needle in s at or after pos, npos if not found
+		 *
+		 * SIMD: blocks of 32 (AVX2) or 16 (SSE2) positions are filtered by
+		 * comparing the first and the last bytes of needle, only candidates
+		 * where both match are compared with memcmp
+		 */
+		static size_t find(string_view s, string_view needle, size_t pos = 0) {
+			const size_t n = s.size(), k = needle.size();
+			if (pos > n || k > n - pos) return string::npos;
+			if (k == 0) return pos;
+			const char *h = s.data();
+			if (k == 1) {
+				const void *p = std::memchr(h + pos, needle[0], n - pos);
+				return p ? static_cast<const char*>(p) - h : string::npos;
+			}
+			const size_t last = n - k;      //last possible start
+			size_t i = pos;
+#if defined(__AVX2__)
+			const __m256i first32 = _mm256_set1_epi8(needle[0]);
+			const __m256i last32 = _mm256_set1_epi8(needle[k - 1]);
+			for (; i + 32 <= last + 1; i += 32) {
+				const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i));
+				const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i + k - 1));
+				uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32)));
+				for (; mask; mask &= mask - 1) {
+					const size_t j = i + std::countr_zero(mask);
+					if (std::memcmp(h + j + 1, needle.data() + 1, k - 2) == 0) return j;
+				}
+			}
+#endif
+#if defined(__SSE2__)
+			const __m128i first16 = _mm_set1_epi8(needle[0]);
+			const __m128i last16 = _mm_set1_epi8(needle[k - 1]);
+			for (; i + 16 <= last + 1; i += 16) {
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + k - 1));
+				uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16)));
+				for (; mask; mask &= mask - 1) {
+					const size_t j = i + std::countr_zero(mask);
+					if (std::memcmp(h + j + 1, needle.data() + 1, k - 2) == 0) return j;
+				}
+			}
+#endif
+			for (; i <= last; ++i)
+				if (h[i] == needle[0] && h[i + k - 1] == needle[k - 1] && std::memcmp(h + i + 1, needle.data() + 1, k - 2) == 0)
+					return i;
+			return string::npos;
+		}
+
+		/**
+		 * @param s      string to search
+		 * @param needle substring to find
+		 * @param pos    last position to search
+		 * @return position of last needle in s at or before pos, npos if not found
+		 *
+		 * SIMD as find(), blocks are searched from the end
+		 */
+		static size_t rfind(string_view s, string_view needle, size_t pos = string::npos) {
+			const size_t n = s.size(), k = needle.size();
+			if (k > n) return string::npos;
+			const char *h = s.data();
+			size_t end = std::min(pos, n - k) + 1;      //starts to search are [0, end)
+			if (k == 0) return end - 1;
+#if defined(__AVX2__)
+			if (k > 1) {
+				const __m256i first32 = _mm256_set1_epi8(needle[0]);
+				const __m256i last32 = _mm256_set1_epi8(needle[k - 1]);
+				for (; end >= 32; end -= 32) {
+					const size_t i = end - 32;
+					const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i));
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(h + i + k - 1));
+					uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32)));
+					while (mask) {
+						const int bit = 31 - std::countl_zero(mask);
+						if (std::memcmp(h + i + bit + 1, needle.data() + 1, k - 2) == 0) return i + bit;
+						mask &= ~(1u << bit);
+					}
+				}
+			}
+#endif
+#if defined(__SSE2__)
+			if (k > 1) {
+				const __m128i first16 = _mm_set1_epi8(needle[0]);
+				const __m128i last16 = _mm_set1_epi8(needle[k - 1]);
+				for (; end >= 16; end -= 16) {
+					const size_t i = end - 16;
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + k - 1));
+					uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16)));
+					while (mask) {
+						const int bit = 31 - std::countl_zero(mask);
+						if (std::memcmp(h + i + bit + 1, needle.data() + 1, k - 2) == 0) return i + bit;
+						mask &= ~(1u << bit);
+					}
+				}
+			}
+#endif
+			while (end-- > 0)
+				if (h[end] == needle[0] && h[end + k - 1] == needle[k - 1]
+					&& std::memcmp(h + end + 1, needle.data() + 1, k - 1) == 0)
+					return end;
+			return string::npos;
+		}
+
+		/**
+		 * @param str    string to search
+		 * @param bdelim before str delimiter
+		 * @param edelim after str delimiter
+		 * @param output first string delimited by bdelim<string>edelim, a view of str,
+		 *               empty if not found
+		 * @param pos    first character to search
+		 *
+		 * @return position of character after edelim or npos if not found
+		 */
+		static size_t firstSubstring(string_view str, string_view bdelim, string_view edelim,
+									 string_view &output, size_t pos = 0) {
+			output = {};
+			size_t begin = find(str, bdelim, pos);
+			if (begin == string::npos) return string::npos;
+			begin += bdelim.size();
+
+			const size_t end = find(str, edelim, begin);
+			if (end == string::npos) return string::npos;
+
+			output = str.substr(begin, end - begin);
+			return end + edelim.size();
+		}
+
 		/**
 		 * @param str    string to search
 		 * @param bdelim before str delimiter
@@ -36,23 +252,48 @@ namespace had {
 		 *
 		 * @pre		<= 0 pos < str.length()
 		 *
+		 * Note: edelim is searched from the second character after bdelim,
+		 *       the string_view version also finds empty strings
+		 *
 		 * @return position of character after edelim or -1 if not found
 		 */
 		static ulong firstSubstring(const string &str, const string &bdelim,
 									const string &edelim, string &output,
 									const long pos = 0) {
 			output = "";
-			int begin = str.find(bdelim, pos);
+			size_t begin = find(str, bdelim, pos);
 			if (begin == string::npos) return -1;
 			begin += bdelim.length();
 
-			int end = str.find(edelim, begin + 1);
+			const size_t end = find(str, edelim, begin + 1);
 			if (end == string::npos) return -1;
 
 			output = str.substr(begin, end - begin);
 			return end + edelim.length();
 		}
 
+		/**
+		 * @param  str     string to search
+		 * @param  bdelim  before str delimiter
+		 * @param  edelim  after str delimiter
+		 * @param  output  last string delimited by bdelim<string>edelim, a view of str,
+		 *                 empty if not found
+		 * @param  pos     last position of edelim
+		 *
+		 * @return position of bdelim or npos if not found
+		 */
+		static size_t lastSubstring(string_view str, string_view bdelim, string_view edelim,
+									string_view &output, size_t pos = string::npos) {
+			output = {};
+			const size_t end = rfind(str, edelim, pos);
+			if (end == string::npos || end < bdelim.size()) return string::npos;
+
+			const size_t begin = rfind(str, bdelim, end - bdelim.size());
+			if (begin == string::npos) return string::npos;
+			output = str.substr(begin + bdelim.size(), end - begin - bdelim.size());
+			return begin;
+		}
+
 		/**
 		 * @param  str     string to search
 		 * @param  bdelim  before str delimiter
@@ -67,64 +308,440 @@ namespace had {
 		static ulong lastSubstring(const string &str, const string &bdelim,
 								   const string &edelim, string &output,
 								   const long pos = string::npos) {
-			output = "";
-			int end = str.find_last_of(edelim, pos);
-			if (end == string::npos) return -1;
-			end -= edelim.length();
+			string_view out;
+			const size_t begin = lastSubstring(string_view(str), bdelim, edelim, out, pos);
+			output = out;
+			return begin == string::npos ? -1 : begin - 1;
+		}
 
-			int begin = str.find_last_of(bdelim, end) + 1;
-			if (begin == string::npos) return -1;
-			output = str.substr(begin, end - begin + 1);
-			return begin - bdelim.length() - 1;
+		/**
+		 * Range of all strings delimited by bdelim<string>edelim, in order,
+		 * as views of str: str must outlive the range
+		 *
+		 *     for (string_view id : String::substrings(log, "<id>", "</id>")) ...
+		 */
+		class Substrings {
+			string_view str, bdelim, edelim;
+
+		public:
+			class iterator {
+				const Substrings *r = nullptr;
+				size_t next = string::npos;     //npos at end
+				string_view current;
+
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef string_view value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef const string_view *pointer;
+				typedef const string_view &reference;
+
+				iterator() = default;
+				iterator(const Substrings *r, size_t pos) : r(r), next(pos) { ++*this; }
+
+				reference operator*() const { return current; }
+				pointer operator->() const { return &current; }
+
+				iterator &operator++() {
+					next = firstSubstring(r->str, r->bdelim, r->edelim, current, next);
+					return *this;
+				}
+
+				iterator operator++(int) {
+					iterator ret = *this;
+					++*this;
+					return ret;
+				}
+
+				bool operator==(const iterator &o) const { return next == o.next; }
+			};
+
+			Substrings(string_view str, string_view bdelim, string_view edelim)
+					: str(str), bdelim(bdelim), edelim(edelim) { }
+
+			//empty delimiters would match forever at the same position
+			iterator begin() const { return bdelim.empty() && edelim.empty() ? end() : iterator(this, 0); }
+			iterator end() const { return iterator(); }
+		};
+
+		static Substrings substrings(string_view str, string_view bdelim, string_view edelim) {
+			return Substrings(str, bdelim, edelim);
+		}
+
+		/**
+		 * Set of bytes, e.g. delimiters, with SIMD search of members
+		 *
+		 * SIMD: exact lookup of 256 bits with pshufb, 32 (AVX2) or 16 (SSSE3)
+		 * bytes at a time: byte b is in set if bit (b >> 4) & 7 of
+		 * table[b >> 7][b & 15] is set
+		 */
+		class CharSet {
+			std::array<bool, 256> member{};
+			alignas(16) uint8_t table[2][16]{};     //bytes < 128, >= 128
+
+			template<bool in>
+			size_t scan(string_view s, size_t pos) const {
+				const size_t n = s.size();
+				if (pos > n) return string::npos;
+				const char *p = s.data();
+				size_t i = pos;
+				//tokens are often short: a few bytes are faster to check one by one
+				for (const size_t head = std::min(n, pos + 16); i < head; ++i)
+					if (member[static_cast<uint8_t>(p[i])] == in) return i;
+#if defined(__AVX2__)
+				const __m256i low32 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table[0])));
+				const __m256i high32 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table[1])));
+				const __m256i bits32 = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+				const __m256i index32 = _mm256_set1_epi8(static_cast<char>(0x8F));   //pshufb gives 0 if bit 7 is set
+				const __m256i sign32 = _mm256_set1_epi8(static_cast<char>(0x80));
+				const __m256i nibble32 = _mm256_set1_epi8(0x0F);
+				for (; i + 32 <= n; i += 32) {
+					const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+					const __m256i row = _mm256_or_si256(_mm256_shuffle_epi8(low32, _mm256_and_si256(v, index32)),
+														_mm256_shuffle_epi8(high32, _mm256_and_si256(_mm256_xor_si256(v, sign32), index32)));
+					const __m256i bit = _mm256_shuffle_epi8(bits32, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble32));
+					uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+					if (!in) mask = ~mask;
+					if (mask) return i + std::countr_zero(mask);
+				}
+#endif
+#if defined(__SSSE3__)
+				const __m128i low16 = _mm_load_si128(reinterpret_cast<const __m128i *>(table[0]));
+				const __m128i high16 = _mm_load_si128(reinterpret_cast<const __m128i *>(table[1]));
+				const __m128i bits16 = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+				const __m128i index16 = _mm_set1_epi8(static_cast<char>(0x8F));
+				const __m128i sign16 = _mm_set1_epi8(static_cast<char>(0x80));
+				const __m128i nibble16 = _mm_set1_epi8(0x0F);
+				for (; i + 16 <= n; i += 16) {
+					const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+					const __m128i row = _mm_or_si128(_mm_shuffle_epi8(low16, _mm_and_si128(v, index16)),
+													 _mm_shuffle_epi8(high16, _mm_and_si128(_mm_xor_si128(v, sign16), index16)));
+					const __m128i bit = _mm_shuffle_epi8(bits16, _mm_and_si128(_mm_srli_epi16(v, 4), nibble16));
+					uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+					if (!in) mask = ~mask & 0xFFFF;
+					if (mask) return i + std::countr_zero(mask);
+				}
+#endif
+				for (; i < n; ++i)
+					if (member[static_cast<uint8_t>(p[i])] == in) return i;
+				return string::npos;
+			}
+
+		public:
+			CharSet() = default;
+
+			/**
+			 * @param chars members of set
+			 */
+			CharSet(string_view chars) { for (char c : chars) insert(c); }
+
+			void insert(char c) {
+				const uint8_t b = c;
+				member[b] = true;
+				table[b >> 7][b & 15] |= 1 << ((b >> 4) & 7);
+			}
+
+			bool contains(char c) const { return member[static_cast<uint8_t>(c)]; }
+
+			/**
+			 * @return position of first member in s at or after pos, npos if not found
+			 */
+			size_t find(string_view s, size_t pos = 0) const { return scan<true>(s, pos); }
+
+			/**
+			 * @return position of first non member in s at or after pos, npos if not found
+			 */
+			size_t findNot(string_view s, size_t pos = 0) const { return scan<false>(s, pos); }
+		};
+
+		/**
+		 * Tokens of a string separated by delimiter bytes, found while iterating
+		 *
+		 * Quoted tokens, e.g. "a b" with quote '"', are returned without quotes,
+		 * quotes inside tokens, e.g. k="a b", are kept, an unclosed quote extends
+		 * to the end of the string. An empty quoted token "" is returned empty,
+		 * also with skipEmpty: it is an explicit empty field
+		 */
+		class Tokens {
+			string_view str;
+			CharSet delims;
+			CharSet stops;      //delims and quote
+			SplitOptions options;
+
+			/**
+			 * @param pos   where to start to search
+			 * @param token next token at or after pos
+			 * @return position after token delimiter, size() + 1 after the last token,
+			 *         npos if there are no more tokens
+			 */
+			size_t next(size_t pos, string_view &token) const {
+				const char quote = options.quote;
+				for (;;) {
+					if (options.skipEmpty) pos = delims.findNot(str, pos);
+					if (pos > str.size()) return string::npos;
+
+					size_t e = pos;
+					if (!quote) e = delims.find(str, pos);
+					else
+						while ((e = stops.find(str, e)) != string::npos && str[e] == quote) {
+							e = str.find(quote, e + 1);     //closing quote
+							if (e == string::npos) break;
+							++e;
+						}
+					if (e == string::npos) e = str.size();
+
+					token = str.substr(pos, e - pos);
+					if (options.skipEmpty && token.empty()) {
+						pos = e + 1;
+						continue;
+					}
+					//one quoted section: its content
+					if (quote && token.size() >= 2 && token.front() == quote && token.find(quote, 1) == token.size() - 1)
+						token = token.substr(1, token.size() - 2);
+					return e + 1;
+				}
+			}
+
+		public:
+			class iterator {
+				const Tokens *r = nullptr;
+				size_t next = string::npos;     //npos at end
+				string_view current;
+
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef string_view value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef const string_view *pointer;
+				typedef const string_view &reference;
+
+				iterator() = default;
+				iterator(const Tokens *r, size_t pos) : r(r), next(pos) { ++*this; }
+
+				reference operator*() const { return current; }
+				pointer operator->() const { return &current; }
+
+				iterator &operator++() {
+					next = r->next(next, current);
+					return *this;
+				}
+
+				iterator operator++(int) {
+					iterator ret = *this;
+					++*this;
+					return ret;
+				}
+
+				bool operator==(const iterator &o) const { return next == o.next; }
+			};
+
+			Tokens(string_view str, const CharSet &delims, SplitOptions options)
+					: str(str), delims(delims), stops(delims), options(options) {
+				if (options.quote) stops.insert(options.quote);
+			}
+
+			iterator begin() const { return iterator(this, 0); }
+			iterator end() const { return iterator(); }
+		};
+
+		/**
+		 * @param str     string to split, must outlive the tokens
+		 * @param delims  delimiter characters, each one separates tokens
+		 * @param options empty tokens and quoting
+		 * @return lazy range of string_view tokens, no copies,
+		 *         e.g. "a,,b" gives "a", "", "b", or "a", "b" skipping empty
+		 */
+		static Tokens split(string_view str, const CharSet &delims, SplitOptions options = {}) {
+			return Tokens(str, delims, options);
+		}
+
+		static Tokens split(string_view str, string_view delims, SplitOptions options = {}) {
+			return Tokens(str, CharSet(delims), options);
+		}
+
+		/**
+		 * @param str   string to split in words separated by whitespace, must outlive the tokens
+		 * @param quote delimiters between quotes do not split, '\0' no quoting
+		 * @return lazy range of string_view words, empty only for a quoted ""
+		 */
+		static Tokens tokenize(string_view str, char quote = '\0') {
+			static const CharSet whitespace(" \t\n\v\f\r");
+			return Tokens(str, whitespace, { true, quote });
+		}
+
+		/**
+		 * Splits large strings, e.g. File::read output, in chunks that end at a
+		 * delimiter, processed by different threads.
+		 * Quoted strings are split in one thread: quotes can cross chunks.
+		 *
+		 * @param threads number of threads, <= 0 hardware concurrency
+		 * @return all tokens as split(), in order
+		 */
+		static vector<string_view> splitParallel(string_view str, const CharSet &delims, SplitOptions options = {}, int threads = 0) {
+			if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+			vector<string_view> ret;
+
+			//not worth to spawn threads for small chunks
+			constexpr size_t minChunk = 1 << 16;
+			if (threads == 1 || options.quote || str.size() < threads * minChunk) {
+				for (string_view t : split(str, delims, options)) ret.push_back(t);
+				return ret;
+			}
+
+			//chunks without their last delimiter have the same tokens as str
+			vector<string_view> chunks;
+			size_t b = 0;
+			for (int i = 1; i < threads; ++i) {
+				const size_t d = delims.find(str, std::max(b, str.size() / threads * i));
+				if (d == string::npos) break;
+				chunks.push_back(str.substr(b, d - b));
+				b = d + 1;
+			}
+			chunks.push_back(str.substr(b));
+
+			vector<vector<string_view>> parts(chunks.size());
+			vector<std::thread> pool;
+			for (size_t i = 0; i < chunks.size(); ++i)
+				pool.emplace_back([&, i] {
+					for (string_view t : split(chunks[i], delims, options)) parts[i].push_back(t);
+				});
+			for (auto &t : pool) t.join();
+
+			size_t total = 0;
+			for (auto &part : parts) total += part.size();
+			ret.reserve(total);
+			for (auto &part : parts) ret.insert(ret.end(), part.begin(), part.end());
+			return ret;
+		}
+
+		static vector<string_view> splitParallel(string_view str, string_view delims, SplitOptions options = {}, int threads = 0) {
+			return splitParallel(str, CharSet(delims), options, threads);
 		}
 
 		/**
 		 * @param  len length of string
-		 * @return string with random alphanumeric [0-9] | [A-Z] | [a-z] characters
+		 * @return string with random alphanumeric [0-9] | [A-Z] | [a-z] characters,
+		 *         from std::rand()
 		 */
 		static string randAlphaNum(const int len) {
-			string ret;
+			string ret(std::max(len, 0), '\0');
 
-			for (int i = 0; i < len; ++i)
-				ret += alphaNum[std::rand() % strlen(alphaNum)];
+			for (char &c : ret)
+				c = alphaNum[std::rand() % alphaNum.size()];
 			return ret;
 		}
 
 		/**
 		 * @param  len length of string
-		 * @return string with random characters
+		 * @return string with random characters, from std::rand()
 		 */
 		static string rand(const int len) {
-			string ret;
+			string ret(std::max(len, 0), '\0');
+
+			for (char &c : ret)
+				c = std::rand() % 256;
+			return ret;
+		}
+
+		/**
+		 * @param  len length of string
+		 * @param  gen generator, e.g. Random::local(), Random, Philox4x32
+		 * @return string with random alphanumeric [0-9] | [A-Z] | [a-z] characters
+		 */
+		template<class G>
+		static string randAlphaNum(const int len, G &gen) { return rand(len, alphaNum, gen); }
 
-			for (int i = 0; i < len; ++i)
-				ret += std::rand() % 256;
+		/**
+		 * @param  len length of string
+		 * @param  gen generator, e.g. Random::local(), Random, Philox4x32
+		 * @return string with random characters
+		 */
+		template<class G>
+		static string rand(const int len, G &gen) {
+			string ret(std::max(len, 0), '\0');
+			randomFill(gen, ret.data(), ret.size());
+			return ret;
+		}
+
+		/**
+		 * @param  len      length of string
+		 * @param  alphabet characters to use, not empty
+		 * @param  gen      generator, e.g. Random::local(), Random, Philox4x32
+		 * @return string with random characters of alphabet
+		 */
+		template<class G>
+		static string rand(const int len, string_view alphabet, G &gen) {
+			string ret(std::max(len, 0), '\0');
+			randomFill(gen, ret.data(), ret.size(), alphabet);
 			return ret;
 		}
 
 
+		/**
+		 * @param  pattern regular expression, ECMAScript grammar
+		 * @return compiled pattern, from a cache of the most recently used
+		 * @throws regex_error if pattern is not valid
+		 */
+		static std::shared_ptr<const regex> compiledRegex(const string &pattern) {
+			return regexCache().get(pattern);
+		}
+
+		/**
+		 * @param n maximum number of patterns kept compiled, 0 disables the cache
+		 */
+		static void regexCacheCapacity(size_t n) { regexCache().resize(n); }
+		static size_t regexCacheSize() { return regexCache().size(); }
+
+		/**
+		 * Replaces str substrings that match regex rgx,
+		 * the result is built in one pass and then moved to str.
+		 *
+		 * @param str 			string to be operated
+		 * @param rgx  			compiled regex to search
+		 * @param replacement 	replacement string
+		 * @param limit 		maximum number of replacements, from the start of str
+		 * @param expandGroups 	if true, $1..$99, $& (match), $` (prefix), $' (suffix)
+		 * 						and $$ in replacement are expanded, otherwise it is literal
+		 * @return number of replacements
+		 */
+		static size_t regex_replace(string &str, const regex &rgx, string_view replacement,
+									size_t limit = string::npos, bool expandGroups = false) {
+			if (limit == 0) return 0;
+			auto begin = sregex_iterator(str.cbegin(), str.cend(), rgx);
+			const auto end = sregex_iterator();
+			if (begin == end) return 0;
+
+			string out;
+			out.reserve(str.size() + str.size() / 8);
+			size_t count = 0;
+			auto last = str.cbegin();
+			for (auto i = begin; i != end && count < limit; ++i, ++count) {
+				const std::smatch &m = *i;
+				out.append(last, m[0].first);
+				if (expandGroups) m.format(std::back_inserter(out), replacement.data(), replacement.data() + replacement.size());
+				else out.append(replacement);
+				last = m[0].second;
+			}
+			out.append(last, str.cend());
+			str = std::move(out);
+			return count;
+		}
+
 		/**
 		 * Replaces any str substrings that matches regex rgx.
 		 * Works in place.
 		 *
 		 * @param str 			string to be operated
-		 * @param rgx  			regex to search
+		 * @param rgx  			regex to search, compiled once and cached
 		 * @param replacement 	replacement string
+		 * @param limit 		maximum number of replacements, from the start of str
+		 * @param expandGroups 	if true, $1..$99, $& (match), $` (prefix), $' (suffix)
+		 * 						and $$ in replacement are expanded, otherwise it is literal
 		 * @return true if at least one replacement took place
 		 */
-		static bool regex_replace(string &str, const string &rgx, const string& replacement) {
-			regex regexp(rgx);
-
-			//Search regex
-			auto begin = sregex_iterator(str.begin(), str.end(), regexp);
-			auto end = sregex_iterator();
-
-			//replace using iterator
-			for (auto i = begin; i != end; ++i)
-				str.replace(i->position(), i->length(), replacement);
-
-			//returns true if at least one match was found and replaced
-			return (begin != end);
+		static bool regex_replace(string &str, const string &rgx, const string& replacement,
+								  size_t limit = string::npos, bool expandGroups = false) {
+			return regex_replace(str, *compiledRegex(rgx), replacement, limit, expandGroups) > 0;
 		}
 	};
 
@@ -0,0 +1,164 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// String benchmarks
+//
+#include <sstream>
+#include <stopwatch/benchmark.hpp>
+#include "AhoCorasick.hpp"
+#include "String.hpp"
+
+using namespace had;
+
+int main(int argc, char **argv) {
+	return Benchmark::main(argc, argv, [](Benchmark &bench) {
+		//1MB of tagged log lines
+		string text;
+		while (text.size() < (1 << 20))
+			text += "time=" + String::randAlphaNum(8) + " <id>" + String::randAlphaNum(12) + "</id> value=42\n";
+
+		bench.run("String::regex_replace 1MB", [&] {
+			string s = text;
+			bool found = String::regex_replace(s, "value=[0-9]+", "value=?");
+			doNotOptimize(found);
+		}, text.size());
+
+		const regex value("value=([0-9]+)");
+		bench.run("String::regex_replace compiled 1MB", [&] {
+			string s = text;
+			size_t count = String::regex_replace(s, value, "value=?");
+			doNotOptimize(count);
+		}, text.size());
+
+		bench.run("String::regex_replace groups 1MB", [&] {
+			string s = text;
+			size_t count = String::regex_replace(s, value, "v=[$1]", string::npos, true);
+			doNotOptimize(count);
+		}, text.size());
+
+		bench.run("String::firstSubstring all 1MB", [&] {
+			string out;
+			long pos = 0;
+			size_t count = 0;
+			while ((pos = String::firstSubstring(text, "<id>", "</id>", out, pos)) != -1) ++count;
+			doNotOptimize(count);
+		}, text.size());
+
+		bench.run("String::firstSubstring string_view all 1MB", [&] {
+			std::string_view out;
+			size_t pos = 0, count = 0;
+			while ((pos = String::firstSubstring(text, "<id>", "</id>", out, pos)) != string::npos) ++count;
+			doNotOptimize(count);
+		}, text.size());
+
+		bench.run("String::substrings 1MB", [&] {
+			size_t count = 0;
+			for (std::string_view id : String::substrings(text, "<id>", "</id>")) count += id.size();
+			doNotOptimize(count);
+		}, text.size());
+
+		const string needle = "</id> value=43";
+		bench.run("std::string::find missing 1MB", [&] {
+			doNotOptimize(text.find(needle));
+		}, text.size());
+
+		bench.run("String::find missing 1MB", [&] {
+			doNotOptimize(String::find(text, needle));
+		}, text.size());
+
+		bench.run("std::string::rfind missing 1MB", [&] {
+			doNotOptimize(text.rfind(needle));
+		}, text.size());
+
+		bench.run("String::rfind missing 1MB", [&] {
+			doNotOptimize(String::rfind(text, needle));
+		}, text.size());
+
+		//500 banned tokens: one scan per token against one pass
+		std::vector<string> banned;
+		for (int i = 0; i < 500; ++i) banned.push_back(String::randAlphaNum(4 + i % 5));
+		const AhoCorasick ac(banned);
+		bench.run("String::find 500 patterns 1MB", [&] {
+			size_t count = 0;
+			for (const string &b : banned)
+				for (size_t p = String::find(text, b); p != string::npos; p = String::find(text, b, p + 1)) ++count;
+			doNotOptimize(count);
+		}, text.size());
+
+		bench.run("AhoCorasick::findAll 500 patterns 1MB", [&] {
+			doNotOptimize(ac.findAll(text).size());
+		}, text.size());
+
+		bench.run("AhoCorasick::replace 500 patterns 1MB", [&] {
+			doNotOptimize(ac.replace(text, "***").size());
+		}, text.size());
+
+		//few start bytes: start state skip
+		const AhoCorasick tags({ "<id>", "</id>", "<name>" });
+		bench.run("AhoCorasick::findAll 3 tags 1MB", [&] {
+			doNotOptimize(tags.findAll(text).size());
+		}, text.size());
+
+		//tokens: "time=... <id>...</id> value=42" lines
+		bench.run("std::istringstream words 1MB", [&] {
+			std::istringstream in(text);
+			size_t n = 0;
+			for (string w; in >> w; ) ++n;
+			doNotOptimize(n);
+		}, text.size());
+
+		bench.run("String::tokenize 1MB", [&] {
+			size_t n = 0;
+			for (string_view w : String::tokenize(text)) n += w.size();
+			doNotOptimize(n);
+		}, text.size());
+
+		bench.run("std::string::find_first_of split 1MB", [&] {
+			vector<string> tokens;
+			size_t b = 0;
+			for (size_t e; (e = text.find_first_of(" =\n", b)) != string::npos; b = e + 1)
+				tokens.push_back(text.substr(b, e - b));
+			doNotOptimize(tokens.size());
+		}, text.size());
+
+		bench.run("String::split 1MB", [&] {
+			vector<string_view> tokens;
+			for (string_view t : String::split(text, " =\n")) tokens.push_back(t);
+			doNotOptimize(tokens.size());
+		}, text.size());
+
+		const string big = text + text + text + text + text + text + text + text;
+		bench.run("String::split 8MB", [&] {
+			vector<string_view> tokens;
+			for (string_view t : String::split(big, " =\n")) tokens.push_back(t);
+			doNotOptimize(tokens.size());
+		}, big.size());
+
+		bench.run("String::splitParallel 8MB", [&] {
+			doNotOptimize(String::splitParallel(big, " =\n").size());
+		}, big.size());
+
+		bench.run("String::randAlphaNum 64KB", [&] {
+			string s = String::randAlphaNum(1 << 16);
+			doNotOptimize(s.data());
+		}, 1 << 16);
+
+		Random rng(1);
+		bench.run("String::randAlphaNum Random 64KB", [&] {
+			string s = String::randAlphaNum(1 << 16, rng);
+			doNotOptimize(s.data());
+		}, 1 << 16);
+
+		Philox4x32 philox(1);
+		bench.run("String::randAlphaNum Philox4x32 64KB", [&] {
+			string s = String::randAlphaNum(1 << 16, philox);
+			doNotOptimize(s.data());
+		}, 1 << 16);
+
+		string buffer(1 << 16, '\0');
+		bench.run("Random::fill bytes 64KB", [&] {
+			rng.fill(buffer.data(), buffer.size());
+			doNotOptimize(buffer.data());
+		}, 1 << 16);
+	});
+}
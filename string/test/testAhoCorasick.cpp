@@ -0,0 +1,169 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "../AhoCorasick.hpp"
+
+using namespace had;
+using std::string;
+using Match = AhoCorasick::Match;
+
+//all occurrences, one search per pattern, in order of end then pattern
+static std::vector<Match> naive(const std::vector<string> &patterns, const string &text) {
+	std::vector<Match> ret;
+	for (uint32_t id = 0; id < patterns.size(); ++id)
+		for (size_t p = text.find(patterns[id]); p != string::npos; p = text.find(patterns[id], p + 1))
+			ret.push_back({ p, patterns[id].size(), id });
+	return ret;
+}
+
+//leftmost longest of all occurrences, one by one
+static std::vector<Match> naiveNonOverlapping(std::vector<Match> all) {
+	std::sort(all.begin(), all.end(), [](const Match &a, const Match &b) {
+		return a.position < b.position || (a.position == b.position && a.length > b.length);
+	});
+	std::vector<Match> ret;
+	size_t end = 0;
+	for (const Match &m : all)
+		if (m.position >= end) {
+			ret.push_back(m);
+			end = m.position + m.length;
+		}
+	return ret;
+}
+
+static void sortMatches(std::vector<Match> &m) {
+	std::sort(m.begin(), m.end(), [](const Match &a, const Match &b) {
+		return a.position + a.length < b.position + b.length
+			   || (a.position + a.length == b.position + b.length && a.pattern < b.pattern);
+	});
+}
+
+TEST_CASE( "AhoCorasick", "[AhoCorasick]" ) {
+
+	SECTION("find") {
+		AhoCorasick ac({ "he", "she", "his", "hers" });
+		REQUIRE(ac.size() == 4);
+		std::vector<Match> m = ac.findAll("ushers");
+		sortMatches(m);
+		REQUIRE(m == std::vector<Match>{ { 2, 2, 0 }, { 1, 3, 1 }, { 2, 4, 3 } });
+		REQUIRE(ac.contains("this"));
+		REQUIRE(!ac.contains("hx sx"));
+		REQUIRE(ac.findAll("").empty());
+	}
+
+	SECTION("same as one search per pattern") {
+		std::mt19937 gen(3);
+		for (int round = 0; round < 50; ++round) {
+			//small alphabet: many overlaps; high bytes: nibble skip of bytes >= 0x80
+			const string alphabet = round % 2 ? "ab" : "ab\x80\xff xyz";
+			auto randString = [&](size_t len) {
+				string s;
+				for (size_t i = 0; i < len; ++i) s += alphabet[gen() % alphabet.size()];
+				return s;
+			};
+			std::vector<string> patterns;
+			for (int i = 0; i < 1 + round % 7; ++i) patterns.push_back(randString(1 + gen() % 4));
+			const string text = randString(gen() % 300);
+			AhoCorasick ac(patterns);
+
+			std::vector<Match> expected = naive(patterns, text), got = ac.findAll(text);
+			sortMatches(expected);
+			sortMatches(got);
+			REQUIRE(got == expected);
+
+			//same lengths may be found by several patterns: compare spans
+			const std::vector<Match> nonOverlapping = ac.findNonOverlapping(text), greedy = naiveNonOverlapping(expected);
+			REQUIRE(nonOverlapping.size() == greedy.size());
+			for (size_t i = 0; i < greedy.size(); ++i) {
+				REQUIRE(nonOverlapping[i].position == greedy[i].position);
+				REQUIRE(nonOverlapping[i].length == greedy[i].length);
+			}
+
+			//streaming in random chunks finds the same
+			std::vector<Match> streamed;
+			auto stream = ac.stream();
+			for (size_t p = 0; p < text.size();) {
+				const size_t len = std::min<size_t>(gen() % 40, text.size() - p);
+				stream.feed(std::string_view(text).substr(p, len), [&](const Match &m) { streamed.push_back(m); });
+				p += len;
+			}
+			REQUIRE(stream.position() == text.size());
+			sortMatches(streamed);
+			REQUIRE(streamed == expected);
+		}
+	}
+
+	SECTION("long text with rare matches") {
+		//start state skip over blocks
+		const string text = string(1000, '.') + "token" + string(77, '-') + "secret" + string(33, ' ') + "tok";
+		AhoCorasick ac({ "secret", "token", "tok" });
+		std::vector<Match> m = ac.findAll(text);
+		sortMatches(m);
+		REQUIRE(m == std::vector<Match>{ { 1000, 3, 2 }, { 1000, 5, 1 }, { 1082, 6, 0 }, { 1121, 3, 2 } });
+	}
+
+	SECTION("replace") {
+		AhoCorasick ac({ "cat", "category", "dog", "do" });
+		REQUIRE(ac.replace("my category: cat and dog, do it", "#") == "my #: # and #, # it");
+		REQUIRE(ac.replace("my category: cat and dog, do it", { "C", "K", "D", "d" }) == "my K: C and D, d it");
+		REQUIRE(ac.replace("nothing here", "#") == "nothing here");
+		REQUIRE(ac.replace("", "#").empty());
+		REQUIRE_THROWS_AS(ac.replace("x", std::vector<string>{ "1" }), std::invalid_argument);
+
+		auto m = ac.findNonOverlapping("catcategory");
+		REQUIRE(m == std::vector<Match>{ { 0, 3, 0 }, { 3, 8, 1 } });
+
+		//"c" is found while "ab" may still be part of "abcd"
+		AhoCorasick nested({ "ab", "c", "abcd" });
+		REQUIRE(nested.findNonOverlapping("abcx") == std::vector<Match>{ { 0, 2, 0 }, { 2, 1, 1 } });
+		REQUIRE(nested.findNonOverlapping("abcd abc") == std::vector<Match>{ { 0, 4, 2 }, { 5, 2, 0 }, { 7, 1, 1 } });
+		REQUIRE(nested.replace("xabcdabcc", { "1", "2", "3" }) == "x3122");
+	}
+
+	SECTION("streaming across chunks") {
+		AhoCorasick ac({ "boundary" });
+		auto s = ac.stream();
+		std::vector<Match> m;
+		auto on = [&](const Match &x) { m.push_back(x); };
+		s.feed("xx bou", on);
+		s.feed("nd", on);
+		s.feed("ary yy boundary", on);
+		REQUIRE(m == std::vector<Match>{ { 3, 8, 0 }, { 15, 8, 0 } });
+		s.reset();
+		s.feed("ary", on);
+		REQUIRE(m.size() == 2);
+	}
+
+	SECTION("streaming stops for good") {
+		AhoCorasick ac({ "ab" });
+		auto s = ac.stream();
+		std::vector<Match> m;
+		auto first = [&](const Match &x) { m.push_back(x); return false; };
+		REQUIRE(s.feed("xa", first));
+		REQUIRE(!s.feed("b ab a", first));
+		REQUIRE(s.stopped());
+		//next chunks are not searched, but counted
+		REQUIRE(!s.feed("b ab", first));
+		REQUIRE(m == std::vector<Match>{ { 1, 2, 0 } });
+		REQUIRE(s.position() == 12);
+
+		s.reset();
+		REQUIRE(!s.stopped());
+		REQUIRE(!s.feed("ab", first));
+		REQUIRE(m.size() == 2);
+		REQUIRE(m[1].position == 0);
+	}
+
+	SECTION("invalid patterns") {
+		REQUIRE_THROWS_AS(AhoCorasick({ "a", "" }), std::invalid_argument);
+		AhoCorasick none({});
+		REQUIRE(none.findAll("abc").empty());
+		REQUIRE(none.replace("abc", "x") == "abc");
+	}
+}
@@ -0,0 +1,173 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Random.hpp"
+#include "../String.hpp"
+
+using namespace had;
+
+TEST_CASE( "Random generators", "[Random]" ) {
+
+	SECTION("xoshiro256++") {
+		Xoshiro256pp a(42), b(42), c(43);
+		std::set<uint64_t> seen;
+		for (int i = 0; i < 1000; ++i) {
+			const uint64_t x = a();
+			REQUIRE(x == b());
+			seen.insert(x);
+		}
+		REQUIRE(seen.size() == 1000);
+		REQUIRE(Xoshiro256pp(42)() != c());
+
+		//jumped stream is not the start of the same stream
+		Xoshiro256pp j(42);
+		j.jump();
+		Xoshiro256pp k(42);
+		k.jump();
+		const uint64_t x = j();
+		REQUIRE(x == k());
+		REQUIRE(seen.count(x) == 0);
+
+		//usable with std distributions
+		std::uniform_int_distribution<int> dice(1, 6);
+		for (int i = 0; i < 100; ++i) {
+			const int d = dice(a);
+			REQUIRE((d >= 1 && d <= 6));
+		}
+	}
+
+	SECTION("xoshiro256++ known answer") {
+		//reference implementation, state { 1, 2, 3, 4 }
+		Xoshiro256pp x({ 1, 2, 3, 4 });
+		for (uint64_t expected : { 41943041ull, 58720359ull, 3588806011781223ull, 3591011842654386ull,
+								   9228616714210784205ull, 9973669472204895162ull })
+			REQUIRE(x() == expected);
+
+		//reference splitmix64 from 0
+		uint64_t seed = 0;
+		REQUIRE(splitmix64(seed) == 0xE220A8397B1DCDAFull);
+		REQUIRE(splitmix64(seed) == 0x6E789E6AA1B965F4ull);
+	}
+
+	SECTION("Philox4x32-10 known answer") {
+		//Random123 test vector, counter and key 0
+		Philox4x32 zero;
+		REQUIRE(zero() == 0xE169C58D6627E8D5ull);
+		REQUIRE(zero() == 0x9B00DBD8BC57AC4Cull);
+	}
+
+	SECTION("Philox4x32 streams and seek") {
+		Philox4x32 p(7, 3);
+		std::vector<uint64_t> seq;
+		for (int i = 0; i < 20; ++i) seq.push_back(p());
+		for (uint64_t n = 0; n < 20; ++n) {
+			Philox4x32 q(7, 3);
+			q.seek(n);
+			REQUIRE(q() == seq[n]);
+		}
+		REQUIRE(Philox4x32(7, 4)() != seq[0]);
+		REQUIRE(Philox4x32(8, 3)() != seq[0]);
+	}
+
+	SECTION("Random bulk fill") {
+		const string_view alphabet = "abc";
+		Random r(1);
+		for (size_t n = 0; n < 40; ++n) {
+			string s(n + 2, '#');
+			r.fill(s.data() + 1, n, alphabet);
+			REQUIRE(s.front() == '#');
+			REQUIRE(s.back() == '#');
+			for (size_t i = 1; i <= n; ++i) REQUIRE(alphabet.find(s[i]) != string::npos);
+
+			string bytes(n + 2, '#');
+			r.fill(bytes.data() + 1, n);
+			REQUIRE(bytes.front() == '#');
+			REQUIRE(bytes.back() == '#');
+		}
+
+		//same seed, same data
+		REQUIRE(Random(5).str(100, alphabet) == Random(5).str(100, alphabet));
+		REQUIRE(Random(5).str(100, alphabet) != Random(6).str(100, alphabet));
+		REQUIRE(Random(5).bytes(100) == Random(5).bytes(100));
+
+		REQUIRE_THROWS_AS(r.fill(nullptr, 1, ""), std::invalid_argument);
+		Philox4x32 p;
+		REQUIRE_THROWS_AS(randomFill(p, nullptr, 1, ""), std::invalid_argument);
+	}
+
+	SECTION("uniform characters") {
+		const string_view alphabet = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+		const int n = 620000;
+		Random r(3);
+		Philox4x32 p(3);
+		for (const string &s : { r.str(n, alphabet), String::rand(n, alphabet, p) }) {
+			std::vector<int> count(256, 0);
+			for (unsigned char c : s) ++count[c];
+			double chi2 = 0;
+			const double expected = double(n) / alphabet.size();
+			for (unsigned char c : alphabet) chi2 += (count[c] - expected) * (count[c] - expected) / expected;
+			//61 degrees of freedom, p < 1e-6 above 130
+			REQUIRE(chi2 < 130);
+		}
+
+		//all bytes
+		const string b = r.bytes(256 * 1000);
+		std::vector<int> count(256, 0);
+		for (unsigned char c : b) ++count[c];
+		double chi2 = 0;
+		for (int c : count) chi2 += (c - 1000.0) * (c - 1000.0) / 1000.0;
+		REQUIRE(chi2 < 400);
+	}
+
+	SECTION("thread streams") {
+		const int nthreads = 4;
+		std::vector<string> out(nthreads);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < nthreads; ++t)
+			threads.emplace_back([t, &out] { out[t] = String::randAlphaNum(64, Random::local()); });
+		for (auto &t : threads) t.join();
+		std::set<string> distinct(out.begin(), out.end());
+		REQUIRE(distinct.size() == nthreads);
+
+		//reproducible parallel streams: same data for any split of work
+		std::vector<string> parts(nthreads);
+		threads.clear();
+		for (int t = 0; t < nthreads; ++t)
+			threads.emplace_back([t, &parts] {
+				Philox4x32 p(99, t);
+				parts[t] = String::randAlphaNum(32, p);
+			});
+		for (auto &t : threads) t.join();
+		for (int t = 0; t < nthreads; ++t) {
+			Philox4x32 p(99, t);
+			REQUIRE(parts[t] == String::randAlphaNum(32, p));
+		}
+	}
+
+	SECTION("String overloads") {
+		Random r(11);
+		const string s = String::randAlphaNum(1000, r);
+		REQUIRE(s.size() == 1000);
+		REQUIRE(s.find_first_not_of("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz") == string::npos);
+		REQUIRE(String::rand(17, r).size() == 17);
+		REQUIRE(String::rand(0, r).empty());
+		REQUIRE(String::rand(-1, r).empty());
+		REQUIRE(String::rand(5, "x", r) == "xxxxx");
+
+		Xoshiro256pp x(1);
+		REQUIRE(String::rand(9, "01", x).find_first_not_of("01") == string::npos);
+
+		//std::rand versions unchanged
+		srand(0);
+		REQUIRE(String::rand(3) == string("g\306i"));
+		REQUIRE(String::randAlphaNum(16) == "7JncCHryDsbzayy4");
+		REQUIRE(String::randAlphaNum(-1).empty());
+	}
+}
@@ -3,7 +3,10 @@
 //
 
 #include <catch2/catch.hpp>
+#include <random>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include "../String.hpp"
 
 using namespace  had;
@@ -81,13 +84,197 @@ TEST_CASE( "String utilities", "[String]" ) {
 		REQUIRE(output == outputExpected[4]);
 		REQUIRE(idx == idxExpected[4]);
 
-		for (int i = 6; i < cases; ++i) {
+		for (int i = 0; i < cases; ++i) {
 			idx = String::lastSubstring(str[1], bdel[i], edel[i], output, pos[i]);
 			REQUIRE(output == outputExpected[i]);
 			REQUIRE(idx == idxExpected[i]);
 		}
 	}
 
+	SECTION("find and rfind") {
+		//all lengths and positions around SIMD block sizes, compared with std::string
+		std::mt19937 gen(1);
+		for (int len = 0; len < 100; ++len) {
+			string hay;
+			for (int i = 0; i < len; ++i) hay += "ab"[gen() % 2];
+			for (int k = 0; k <= 5; ++k) {
+				string needle;
+				for (int i = 0; i < k; ++i) needle += "ab"[gen() % 2];
+				for (size_t pos = 0; pos <= hay.size() + 1; ++pos) {
+					REQUIRE(String::find(hay, needle, pos) == hay.find(needle, pos));
+					REQUIRE(String::rfind(hay, needle, pos) == hay.rfind(needle, pos));
+				}
+				REQUIRE(String::rfind(hay, needle) == hay.rfind(needle));
+			}
+		}
+		const string big = string(1000, 'x') + "needle" + string(1000, 'x') + "needle" + string(7, 'x');
+		REQUIRE(String::find(big, "needle") == 1000);
+		REQUIRE(String::find(big, "needle", 1001) == 2006);
+		REQUIRE(String::rfind(big, "needle") == 2006);
+		REQUIRE(String::rfind(big, "needle", 2005) == 1000);
+		REQUIRE(String::find(big, "needlf") == string::npos);
+		REQUIRE(String::find(big, std::string_view("x\0x", 3)) == string::npos);
+	}
+
+	SECTION("string_view substrings") {
+		const string s = "../test/samples/files/";
+		std::string_view out;
+		REQUIRE(String::firstSubstring(s, "/", "/", out) == 8);
+		REQUIRE(out == "test");
+		REQUIRE(out.data() == s.data() + 3);     //no copy
+		REQUIRE(String::firstSubstring(s, "t/s", "s/", out) == 16);
+		REQUIRE(out == "ample");
+		REQUIRE(String::firstSubstring(s, "/", "__NotExisting__", out) == string::npos);
+		REQUIRE(out.empty());
+
+		//empty strings are found
+		REQUIRE(String::firstSubstring("<id></id><id>7</id>", "<id>", "</id>", out) == 9);
+		REQUIRE(out.empty());
+
+		REQUIRE(String::lastSubstring(s, "/", "/", out) == 15);
+		REQUIRE(out == "files");
+		REQUIRE(String::lastSubstring(s, "/", "/", out, 18) == 7);
+		REQUIRE(out == "samples");
+		REQUIRE(String::lastSubstring(s, "t/s", "s/", out, 18) == 6);
+		REQUIRE(out == "ample");
+		//delimiters are strings, not sets of characters
+		REQUIRE(String::lastSubstring(s, "/f", "s/", out) == 15);
+		REQUIRE(out == "ile");
+		REQUIRE(String::lastSubstring(s, "/", "/", out, 1) == string::npos);
+		REQUIRE(out.empty());
+	}
+
+	SECTION("substrings iterator") {
+		const string log = "a <id>1</id> b <id>22</id> <id></id> c <id>333";
+		std::vector<std::string_view> ids;
+		for (std::string_view id : String::substrings(log, "<id>", "</id>")) ids.push_back(id);
+		REQUIRE(ids == std::vector<std::string_view>{ "1", "22", "" });
+
+		REQUIRE(String::substrings(log, "[", "]").begin() == String::substrings(log, "[", "]").end());
+		REQUIRE(String::substrings(log, "", "").begin() == String::substrings(log, "", "").end());
+		auto words = String::substrings("a b c ", "", " ");
+		REQUIRE(std::distance(words.begin(), words.end()) == 3);
+	}
+
+	SECTION("CharSet") {
+		//all bytes, members anywhere around SIMD block sizes
+		std::mt19937 gen(2);
+		for (int round = 0; round < 50; ++round) {
+			string members;
+			for (int i = 0; i < round % 8; ++i) members += static_cast<char>(gen());
+			const String::CharSet set(members);
+			string s;
+			for (int i = 0; i < 100; ++i) s += static_cast<char>(gen());
+			for (size_t pos = 0; pos <= s.size() + 1; ++pos) {
+				const size_t in = pos > s.size() ? string::npos : s.find_first_of(members, pos);
+				const size_t out = pos > s.size() ? string::npos : s.find_first_not_of(members, pos);
+				REQUIRE(set.find(s, pos) == in);
+				REQUIRE(set.findNot(s, pos) == out);
+			}
+		}
+		const String::CharSet set("\x80\xFF\x0F,");
+		REQUIRE(set.contains('\xFF'));
+		REQUIRE(!set.contains('\x7F'));
+		REQUIRE(set.find(string(40, 'a') + "\xFF") == 40);
+		REQUIRE(set.find(string(40, '\x8F')) == string::npos);
+		REQUIRE(String::CharSet().find("abc") == string::npos);
+	}
+
+	SECTION("split") {
+		auto tokens = [](const auto &range) {
+			std::vector<string> ret;
+			for (std::string_view t : range) ret.emplace_back(t);
+			return ret;
+		};
+		typedef std::vector<string> vs;
+
+		REQUIRE(tokens(String::split("a,,b", ",")) == vs{ "a", "", "b" });
+		REQUIRE(tokens(String::split("a,,b", ",", { .skipEmpty = true })) == vs{ "a", "b" });
+		REQUIRE(tokens(String::split(",a;b,", ",;")) == vs{ "", "a", "b", "" });
+		REQUIRE(tokens(String::split(",a;b,", ",;", { .skipEmpty = true })) == vs{ "a", "b" });
+		REQUIRE(tokens(String::split("", ",")) == vs{ "" });
+		REQUIRE(tokens(String::split("", ",", { .skipEmpty = true })).empty());
+		REQUIRE(tokens(String::split(",,,", ",", { .skipEmpty = true })).empty());
+		REQUIRE(tokens(String::split("abc", "")) == vs{ "abc" });
+
+		//no copies
+		const string line = "user:x:1000:1000::/home/user:/bin/bash";
+		auto fields = String::split(line, ":");
+		REQUIRE(std::distance(fields.begin(), fields.end()) == 7);
+		REQUIRE(fields.begin()->data() == line.data());
+
+		//long strings, compared with find loops
+		std::mt19937 gen(3);
+		for (int len = 0; len < 200; len += 7) {
+			string s;
+			for (int i = 0; i < len; ++i) s += "ab, ;"[gen() % 5];
+			vs expected;
+			size_t b = 0;
+			for (size_t e; (e = s.find_first_of(",;", b)) != string::npos; b = e + 1) expected.push_back(s.substr(b, e - b));
+			expected.push_back(s.substr(b));
+			REQUIRE(tokens(String::split(s, ",;")) == expected);
+			std::erase(expected, "");
+			REQUIRE(tokens(String::split(s, ",;", { .skipEmpty = true })) == expected);
+		}
+	}
+
+	SECTION("split quoted") {
+		auto tokens = [](const auto &range) {
+			std::vector<string> ret;
+			for (std::string_view t : range) ret.emplace_back(t);
+			return ret;
+		};
+		typedef std::vector<string> vs;
+
+		REQUIRE(tokens(String::split("a,\"b,c\",d", ",", { .quote = '"' })) == vs{ "a", "b,c", "d" });
+		REQUIRE(tokens(String::split("k=\"a,b\",\"\",x", ",", { .skipEmpty = true, .quote = '"' })) == vs{ "k=\"a,b\"", "", "x" });
+		REQUIRE(tokens(String::split("\"a\"\"b\",c", ",", { .quote = '"' })) == vs{ "\"a\"\"b\"", "c" });
+		REQUIRE(tokens(String::split("a,\"b,c", ",", { .quote = '"' })) == vs{ "a", "\"b,c" });
+		REQUIRE(tokens(String::split("\"a,b\"", ",")) == vs{ "\"a", "b\"" });
+	}
+
+	SECTION("tokenize") {
+		auto tokens = [](const auto &range) {
+			std::vector<string> ret;
+			for (std::string_view t : range) ret.emplace_back(t);
+			return ret;
+		};
+		typedef std::vector<string> vs;
+
+		REQUIRE(tokens(String::tokenize("  ls -l\t/tmp \n\n")) == vs{ "ls", "-l", "/tmp" });
+		REQUIRE(tokens(String::tokenize(" \r\n ")).empty());
+		REQUIRE(tokens(String::tokenize("echo 'a  b' c", '\'')) == vs{ "echo", "a  b", "c" });
+		//explicit empty argument is kept
+		REQUIRE(tokens(String::tokenize("cmd '' x", '\'')) == vs{ "cmd", "", "x" });
+
+		//as istringstream
+		string text;
+		std::mt19937 gen(4);
+		for (int i = 0; i < 2000; ++i) text += "xy \t\n"[gen() % 5];
+		std::istringstream in(text);
+		vs expected;
+		for (string w; in >> w; ) expected.push_back(w);
+		REQUIRE(tokens(String::tokenize(text)) == expected);
+	}
+
+	SECTION("splitParallel") {
+		string text;
+		std::mt19937 gen(5);
+		for (int i = 0; i < 300000; ++i) text += "abc,,\n"[gen() % 6];
+		for (bool skip : { false, true })
+			for (int threads : { 1, 2, 3, 8 }) {
+				std::vector<std::string_view> serial;
+				for (std::string_view t : String::split(text, ",\n", { .skipEmpty = skip })) serial.push_back(t);
+				const auto parallel = String::splitParallel(text, ",\n", { .skipEmpty = skip }, threads);
+				REQUIRE(parallel == serial);
+				REQUIRE(parallel.front().data() == serial.front().data());
+			}
+
+		//delimiters only at the end
+		const string tail = string(300000, 'a') + ",";
+		REQUIRE(String::splitParallel(tail, ",", {}, 4) == std::vector<std::string_view>{ std::string_view(tail).substr(0, 300000), "" });
+	}
+
 	SECTION("rnd") {
 		srand(0);
 		REQUIRE(String::rand(3) == string("g\306i"));
@@ -109,4 +296,86 @@ TEST_CASE( "String utilities", "[String]" ) {
 			REQUIRE(f == found[i]);
 		}
 	}
+
+	SECTION("regex_replace other lengths") {
+		string s = "a1b22c333d";
+		REQUIRE(String::regex_replace(s, "[0-9]+", "<num>"));
+		REQUIRE(s == "a<num>b<num>c<num>d");
+		REQUIRE(String::regex_replace(s, "<num>", ""));
+		REQUIRE(s == "abcd");
+
+		//empty matches
+		s = "abc";
+		REQUIRE(String::regex_replace(s, "x*", "-"));
+		REQUIRE(s == "-a-b-c-");
+	}
+
+	SECTION("regex_replace compiled, limit and groups") {
+		const regex date("(\\d{4})-(\\d{2})-(\\d{2})");
+		string s = "from 2020-05-27 to 2026-10-19 and 1999-01-01";
+		string t = s;
+		REQUIRE(String::regex_replace(t, date, "$3/$2/$1", string::npos, true) == 3);
+		REQUIRE(t == "from 27/05/2020 to 19/10/2026 and 01/01/1999");
+
+		t = s;
+		REQUIRE(String::regex_replace(t, date, "$3/$2/$1", 2, true) == 2);
+		REQUIRE(t == "from 27/05/2020 to 19/10/2026 and 1999-01-01");
+
+		//literal replacement by default
+		t = s;
+		REQUIRE(String::regex_replace(t, date, "$1", 1) == 1);
+		REQUIRE(t == "from $1 to 2026-10-19 and 1999-01-01");
+
+		t = s;
+		REQUIRE(String::regex_replace(t, date, "[$&]", string::npos, true) == 3);
+		REQUIRE(t == "from [2020-05-27] to [2026-10-19] and [1999-01-01]");
+
+		t = s;
+		REQUIRE(String::regex_replace(t, date, "x", 0) == 0);
+		REQUIRE(t == s);
+
+		REQUIRE(String::regex_replace(t, "\\d+", "#", 1));
+		REQUIRE(t == "from #-05-27 to 2026-10-19 and 1999-01-01");
+	}
+
+	SECTION("regex cache") {
+		REQUIRE(String::compiledRegex("a+b") == String::compiledRegex("a+b"));
+		REQUIRE(String::compiledRegex("a+b") != String::compiledRegex("a+c"));
+		REQUIRE_THROWS_AS(String::compiledRegex("(unclosed"), std::regex_error);
+
+		String::regexCacheCapacity(2);
+		REQUIRE(String::regexCacheSize() <= 2);
+		auto kept = String::compiledRegex("p0");
+		String::compiledRegex("p1");
+		String::compiledRegex("p2");
+		String::compiledRegex("p3");
+		REQUIRE(String::regexCacheSize() == 2);
+		//evicted patterns are compiled again, held ones stay valid
+		REQUIRE(String::compiledRegex("p0") != kept);
+		REQUIRE(regex_search("xp0x", *kept));
+
+		String::regexCacheCapacity(0);
+		string s = "aaa";
+		REQUIRE(String::regex_replace(s, "a", "b"));
+		REQUIRE(s == "bbb");
+		REQUIRE(String::regexCacheSize() == 0);
+		String::regexCacheCapacity(64);
+
+		//concurrent use
+		std::vector<std::thread> threads;
+		std::vector<string> results(8);
+		for (int t = 0; t < 8; ++t)
+			threads.emplace_back([t, &results] {
+				for (int i = 0; i < 200; ++i) {
+					string s = "k" + std::to_string(t) + "=" + std::to_string(i);
+					String::regex_replace(s, "k" + std::to_string(i % 16) + "=(\\d+)", "v=$1", string::npos, true);
+					if (i % 16 == t) results[t] += s + ";";
+				}
+			});
+		for (auto &t : threads) t.join();
+		for (int t = 0; t < 8; ++t) {
+			REQUIRE(results[t].find("v=" + std::to_string(t) + ";") != string::npos);
+			REQUIRE(results[t].find("k") == string::npos);
+		}
+	}
 }
@@ -0,0 +1,220 @@
+/**
+ * Concurrent Table2
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Table2 that can change while it is being read by other threads:
+ *   - the current table is an immutable Table2 published through an
+ *     atomic shared_ptr, readers never wait for the writer mutex nor for a
+ *     table to be built
+ *   - writers copy the current table, apply a batch of changes and publish
+ *     the copy (copy on write), writers are serialized by a mutex
+ *   - a batch that breaks the one-to-one relationship is rejected,
+ *     the published table does not change
+ *   - old tables are freed when the last reader holding them releases them
+ *
+ * Loading the atomic shared_ptr is not wait free: libstdc++ guards it with
+ * an internal spin lock, so snapshot(), size(), value() and key() may spin
+ * while a publish stores the new table, and they update the reference
+ * count, a cache line shared by all readers. Hot readers should use a
+ * Reader: it keeps its own snapshot and, until a new table is published,
+ * only loads a version number, wait free and without shared writes:
+ *
+ *     ConcurrentTable2<int, string> table(m);
+ *
+ *     //reader thread
+ *     auto reader = table.reader();
+ *     const string &name = reader->value(42);    //valid until next reader access
+ *
+ *     //writer thread
+ *     table.publish(ConcurrentTable2<int, string>::Batch().set(42, "new").erase(7));
+ */
+
+#ifndef __HAD_CONCURRENTTABLE2_HPP__
+#define __HAD_CONCURRENTTABLE2_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "Table2.hpp"
+
+using std::map;
+
+namespace had {
+
+	template <class K, class V>
+	class ConcurrentTable2 {
+	public:
+		typedef std::shared_ptr<const Table2<K,V>> Snapshot;
+
+		/**
+		 * Changes published together, readers see all or none of them
+		 */
+		class Batch {
+			friend class ConcurrentTable2;
+			map<K, std::optional<V>> changes;     //nullopt erases
+
+		public:
+			/**
+			 * Inserts or replaces the value at key
+			 */
+			Batch &set(const K &key, const V &value) {
+				changes.insert_or_assign(key, value);
+				return *this; //for method chain
+			}
+
+			/**
+			 * Removes key, if it exists when the batch is published
+			 */
+			Batch &erase(const K &key) {
+				changes.insert_or_assign(key, std::nullopt);
+				return *this;
+			}
+
+			bool empty() const { return changes.empty(); }
+			size_t size() const { return changes.size(); }
+		};
+
+		/**
+		 * Per thread view of the table, must not be shared between threads
+		 * nor outlive the table
+		 */
+		class Reader {
+			const ConcurrentTable2 *owner;
+			Snapshot snap;
+			uint64_t seen;
+
+		public:
+			explicit Reader(const ConcurrentTable2 &table)
+				: owner(&table), seen(table.version()) { snap = table.snapshot(); }
+
+			/**
+			 * Wait free while no table is published, after a publish the
+			 * first call loads the new snapshot and may spin as snapshot()
+			 *
+			 * @return latest published table, references into it are valid
+			 *         until the next call on this reader
+			 */
+			const Table2<K,V> &get() {
+				//only reads a shared counter while there are no updates
+				const uint64_t v = owner->version();
+				if (v != seen) {
+					snap = owner->snapshot();
+					seen = v;
+				}
+				return *snap;
+			}
+
+			const Table2<K,V> &operator*() { return get(); }
+			const Table2<K,V> *operator->() { return &get(); }
+		};
+
+	private:
+		std::atomic<Snapshot> current;
+		std::atomic<uint64_t> version_ { 0 };
+		std::mutex writer;
+
+		static Snapshot make(map<K,V> &&m) {
+			auto t = std::make_shared<const Table2<K,V>>(std::move(m));
+			if (!t->oneToOne()) throw std::invalid_argument("ConcurrentTable2: duplicated value");
+			return t;
+		}
+
+		void store(Snapshot t) {
+			current.store(std::move(t), std::memory_order_release);
+			//after the table: a reader that sees the new version loads the new table
+			version_.fetch_add(1, std::memory_order_release);
+		}
+
+	public:
+
+		/**
+		 * @param m map<K,V> that represents the table Keys and Values
+		 * @throws invalid_argument if m has duplicated values
+		 */
+		explicit ConcurrentTable2(const map<K,V> &m = {}) : current(make(map<K,V>(m))) { }
+
+		ConcurrentTable2(const ConcurrentTable2 &) = delete;
+		ConcurrentTable2 &operator=(const ConcurrentTable2 &) = delete;
+
+		/**
+		 * May spin while a publish stores the new table, see Reader
+		 *
+		 * @return current table, it does not change while it is held
+		 */
+		Snapshot snapshot() const { return current.load(std::memory_order_acquire); }
+
+		/**
+		 * @return a view of the table for the calling thread
+		 */
+		Reader reader() const { return Reader(*this); }
+
+		/**
+		 * @return number of tables published, changes on each publish
+		 */
+		uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+		/**
+		 * @return number of key, value pairs in current table
+		 */
+		int size() const { return snapshot()->size(); }
+
+		/**
+		 * May spin while a publish stores the new table, see Reader
+		 *
+		 * @return copy of value at key in current table
+		 */
+		template<class U = K>
+		V value(const U &key) const { return snapshot()->value(key); }
+
+		/**
+		 * May spin while a publish stores the new table, see Reader
+		 *
+		 * @return copy of key at value in current table
+		 */
+		template<class U = V>
+		K key(const U &value) const { return snapshot()->key(value); }
+
+		/**
+		 * Applies batch to a copy of the current table and publishes it,
+		 * O(n) per batch, so group changes in as few batches as possible
+		 *
+		 * @return version of the published table
+		 * @throws invalid_argument if the result has duplicated values,
+		 *         the current table is not changed
+		 */
+		uint64_t publish(const Batch &batch) {
+			std::lock_guard<std::mutex> lock(writer);
+			if (batch.empty()) return version();
+			const Snapshot old = snapshot();
+			map<K,V> m(old->begin(), old->end());
+			for (const auto &[key, value] : batch.changes) {
+				if (value) m.insert_or_assign(key, *value);
+				else m.erase(key);
+			}
+			store(make(std::move(m)));
+			return version();
+		}
+
+		/**
+		 * Publishes a new table with the contents of m
+		 *
+		 * @return version of the published table
+		 * @throws invalid_argument if m has duplicated values,
+		 *         the current table is not changed
+		 */
+		uint64_t replace(map<K,V> m) {
+			Snapshot t = make(std::move(m));
+			std::lock_guard<std::mutex> lock(writer);
+			store(std::move(t));
+			return version();
+		}
+	};
+
+}
+
+#endif //__HAD_CONCURRENTTABLE2_HPP__
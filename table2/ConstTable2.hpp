@@ -0,0 +1,132 @@
+/**
+ * Compile time Table2
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Associative array (map) that can be indexed by key and by value,
+ * for static mappings (opcodes, status codes, enum names):
+ *   - built at compile time from an array of pairs, sorted by key and by
+ *     value, duplicated keys or values are compile errors
+ *   - declared constexpr, it lives in .rodata: no startup code, no heap
+ *   - lookups are constexpr binary searches: with constant arguments they
+ *     are done at compile time, and a missing key is a compile error
+ *
+ * K and V must be literal types, e.g. integers, enums, std::string_view.
+ *
+ * Use it as:
+ *     constexpr auto names = makeConstTable2<Op, std::string_view>({
+ *         { Op::add, "add" }, { Op::sub, "sub" }
+ *     });
+ *     static_assert(names.value(Op::add) == "add");
+ *     Op op = names.key(userInput);     //runtime, throws out_of_range
+ */
+
+#ifndef __HAD_CONSTTABLE2_HPP__
+#define __HAD_CONSTTABLE2_HPP__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace had {
+
+	template <class K, class V, size_t N>
+	class ConstTable2 {
+
+		std::array<K, N> keys_{};        //sorted
+		std::array<V, N> values_{};      //values_[i] is value of keys_[i]
+		std::array<size_t, N> rev{};     //positions in keys_/values_ sorted by value
+
+		template<class U>
+		constexpr size_t findKey(const U &key) const {
+			const auto it = std::lower_bound(keys_.begin(), keys_.end(), key,
+											 [](const K &k, const U &x) { return k < x; });
+			return it != keys_.end() && !(key < *it) ? it - keys_.begin() : N;
+		}
+
+		template<class U>
+		constexpr size_t findValue(const U &value) const {
+			const auto it = std::lower_bound(rev.begin(), rev.end(), value,
+											 [this](size_t p, const U &x) { return values_[p] < x; });
+			return it != rev.end() && !(value < values_[*it]) ? *it : N;
+		}
+
+	public:
+
+		/**
+		 * Only evaluated at compile time, errors are compile errors
+		 *
+		 * @param pairs key, value pairs in any order
+		 * @throws invalid_argument on duplicated keys or values (compile error)
+		 */
+		consteval ConstTable2(std::array<std::pair<K, V>, N> pairs) {
+			std::sort(pairs.begin(), pairs.end(), [](auto &a, auto &b) { return a.first < b.first; });
+			for (size_t i = 0; i < N; ++i) {
+				if (i && !(pairs[i - 1].first < pairs[i].first))
+					throw std::invalid_argument("ConstTable2: duplicated key");
+				keys_[i] = pairs[i].first;
+				values_[i] = pairs[i].second;
+				rev[i] = i;
+			}
+			std::sort(rev.begin(), rev.end(), [this](size_t a, size_t b) { return values_[a] < values_[b]; });
+			for (size_t i = 1; i < N; ++i)
+				if (!(values_[rev[i - 1]] < values_[rev[i]]))
+					throw std::invalid_argument("ConstTable2: duplicated value");
+		}
+
+		/**
+		 * @return number of key, value pairs in table
+		 */
+		constexpr int size() const { return N; }
+
+		/**
+		 * @param key to search value
+		 * @return value at key
+		 */
+		template<class U = K>
+		constexpr const V& value(const U &key) const {
+			const size_t i = findKey(key);
+			if (i == N) throw std::out_of_range("ConstTable2: key not found");
+			return values_[i];
+		}
+
+		/**
+		 * @param value to search key
+		 * @return key at value
+		 */
+		template<class U = V>
+		constexpr const K& key(const U &value) const {
+			const size_t i = findValue(value);
+			if (i == N) throw std::out_of_range("ConstTable2: value not found");
+			return keys_[i];
+		}
+
+		/**
+		 * @return true if key is in table
+		 */
+		template<class U = K>
+		constexpr bool containsKey(const U &key) const { return findKey(key) != N; }
+
+		/**
+		 * @return true if value is in table
+		 */
+		template<class U = V>
+		constexpr bool containsValue(const U &value) const { return findValue(value) != N; }
+	};
+
+
+	/**
+	 * Deduces N from a braced list of pairs:
+	 *     makeConstTable2<int, std::string_view>({ { 1, "One" }, { 3, "Three" } })
+	 */
+	template <class K, class V, size_t N>
+	consteval ConstTable2<K, V, N> makeConstTable2(const std::pair<K, V> (&pairs)[N]) {
+		std::array<std::pair<K, V>, N> a;
+		std::copy(pairs, pairs + N, a.begin());
+		return ConstTable2<K, V, N>(a);
+	}
+
+}
+
+#endif //__HAD_CONSTTABLE2_HPP__
@@ -0,0 +1,264 @@
+/**
+ * Flat Table2
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Associative array (map) that can be indexed by key and by value,
+ * with the same interface as Table2, but:
+ *   - keys and values are stored in two contiguous arrays, one allocation
+ *     each, instead of one tree node per entry
+ *   - the forward index is the keys array itself, in Eytzinger (BFS) order:
+ *     children of node i are 2i and 2i+1, so the first levels of the search
+ *     share a few cache lines and the next levels can be prefetched
+ *   - the reverse index is an array of positions in Eytzinger order of values
+ *   - searches are branchless: the comparison result selects the child
+ *   - values(keys) / keys(values) interleave several searches, so their
+ *     cache misses overlap
+ *
+ * Table is immutable, it must be fully created with constructor
+ * Table must have a relationship one-to-one,
+ * duplicated values will NOT all be accessed by value
+ *
+ * Lookups are heterogeneous: any type comparable with K (V) with < can be
+ * searched, e.g. string_view or const char* in a table of strings.
+ *
+ * Ref: Khuong, Morin, "Array layouts for comparison-based searching", 2017
+ */
+
+#ifndef __HAD_FLATTABLE2_HPP__
+#define __HAD_FLATTABLE2_HPP__
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+namespace had {
+
+	template <class K, class V>
+	class FlatTable2 {
+
+		vector<K> keys_;            //Eytzinger order of keys
+		vector<V> values_;          //values_[i] is value of keys_[i]
+		vector<uint32_t> rev;       //positions in keys_/values_, Eytzinger order of values
+
+		//lookups interleaved by values(keys) and keys(values)
+		static constexpr size_t batch = 16;
+
+		//elements of T per cache line, prefetch distance of one level
+		template<class T>
+		static constexpr size_t perLine = std::max<size_t>(1, 64 / sizeof(T));
+
+		/**
+		 * @return for each Eytzinger position (0 based), the sorted position
+		 */
+		static vector<uint32_t> order(size_t n) {
+			vector<uint32_t> ord(n);
+			uint32_t r = 0;
+			//in order traversal of implicit tree, 1 based
+			auto fill = [&](auto &self, size_t i) -> void {
+				if (i > n) return;
+				self(self, 2 * i);
+				ord[i - 1] = r++;
+				self(self, 2 * i + 1);
+			};
+			fill(fill, 1);
+			return ord;
+		}
+
+		/**
+		 * Builds both indexes from pairs sorted by key without duplicated keys
+		 */
+		template<class It>
+		void build(It first, size_t n) {
+			if (n >= std::numeric_limits<uint32_t>::max())
+				throw std::length_error("FlatTable2: too many entries");
+			const vector<uint32_t> ord = order(n);
+
+			//sorted position of each pair
+			vector<It> sorted(n);
+			for (size_t i = 0; i < n; ++i, ++first) sorted[i] = first;
+
+			keys_.reserve(n);
+			values_.reserve(n);
+			for (size_t i = 0; i < n; ++i) {
+				keys_.push_back(std::move(sorted[ord[i]]->first));
+				values_.push_back(std::move(sorted[ord[i]]->second));
+			}
+
+			//reverse index: positions sorted by value, then in Eytzinger order
+			vector<uint32_t> byValue(n);
+			for (uint32_t i = 0; i < n; ++i) byValue[i] = i;
+			std::stable_sort(byValue.begin(), byValue.end(),
+							 [this](uint32_t a, uint32_t b) { return values_[a] < values_[b]; });
+			rev.resize(n);
+			for (size_t i = 0; i < n; ++i) rev[i] = byValue[ord[i]];
+		}
+
+		//k is the 1 based path after the search left the tree: remove the
+		//trailing right turns and the last left turn to get the lower bound
+		static size_t lowerBound(size_t k) { return k >> (std::countr_one(k) + 1); }
+
+		/**
+		 * @return 1 based Eytzinger position of first element not less than x, 0 if none
+		 */
+		template<class T, class Less>
+		static size_t search(const T *a, size_t n, Less less) {
+			size_t k = 1;
+			while (k <= n) {
+				__builtin_prefetch(a + std::min(k * perLine<T>, n) - 1);
+				k = 2 * k + less(a[k - 1]);
+			}
+			return lowerBound(k);
+		}
+
+		template<class U>
+		size_t findKey(const U &key) const {
+			const size_t k = search(keys_.data(), keys_.size(), [&key](const K &x) { return x < key; });
+			return k && !(key < keys_[k - 1]) ? k : 0;
+		}
+
+		template<class U>
+		size_t findValue(const U &value) const {
+			const size_t k = search(rev.data(), rev.size(), [this, &value](uint32_t p) { return values_[p] < value; });
+			return k && !(value < values_[rev[k - 1]]) ? k : 0;
+		}
+
+		/**
+		 * Interleaved searches of the same tree, levels of all searches
+		 * of a batch are done together
+		 *
+		 * @param out 1 based Eytzinger positions found, 0 if not found
+		 */
+		template<class T, class U, class Less, class Equal>
+		static void searchBatch(const T *a, size_t n, std::span<const U> xs, size_t *out, Less less, Equal equal) {
+			const int levels = std::bit_width(n);
+			for (size_t b = 0; b < xs.size(); b += batch) {
+				const size_t m = std::min(batch, xs.size() - b);
+				size_t k[batch];
+				for (size_t j = 0; j < m; ++j) k[j] = 1;
+				for (int level = 0; level < levels; ++level)
+					for (size_t j = 0; j < m; ++j) {
+						if (k[j] > n) continue;   //last level is not full
+						__builtin_prefetch(a + std::min(k[j] * perLine<T>, n) - 1);
+						k[j] = 2 * k[j] + less(a[k[j] - 1], xs[b + j]);
+					}
+				for (size_t j = 0; j < m; ++j) {
+					const size_t p = lowerBound(k[j]);
+					out[b + j] = p && equal(a[p - 1], xs[b + j]) ? p : 0;
+				}
+			}
+		}
+
+	public:
+
+		/**
+		 * @param m map<K,V> that represents the table Keys and Values
+		 * @pre   m must not have duplicated values
+		 */
+		FlatTable2(const map<K,V> &m) { build(m.begin(), m.size()); }
+
+		/**
+		 * @param pairs key, value pairs in any order
+		 * @pre   pairs must not have duplicated values
+		 * @throws invalid_argument if there are duplicated keys
+		 */
+		FlatTable2(vector<std::pair<K,V>> pairs) {
+			std::sort(pairs.begin(), pairs.end(), [](auto &a, auto &b) { return a.first < b.first; });
+			for (size_t i = 1; i < pairs.size(); ++i)
+				if (!(pairs[i - 1].first < pairs[i].first))
+					throw std::invalid_argument("FlatTable2: duplicated key");
+			build(pairs.begin(), pairs.size());
+		}
+
+		/**
+		 * @return number of key, value pairs in table
+		 */
+		int size() const { return keys_.size(); }
+
+		/**
+		 * @param key to search value
+		 * @return value at key
+		 */
+		template<class U = K>
+		const V& value(const U &key) const {
+			const size_t k = findKey(key);
+			if (!k) throw std::out_of_range("FlatTable2: key not found");
+			return values_[k - 1];
+		}
+
+		/**
+		 * @param value to search key
+		 * @return key at value
+		 */
+		template<class U = V>
+		const K& key(const U &value) const {
+			const size_t k = findValue(value);
+			if (!k) throw std::out_of_range("FlatTable2: value not found");
+			return keys_[rev[k - 1]];
+		}
+
+		/**
+		 * @return true if key is in table
+		 */
+		template<class U = K>
+		bool containsKey(const U &key) const { return findKey(key); }
+
+		/**
+		 * @return true if value is in table
+		 */
+		template<class U = V>
+		bool containsValue(const U &value) const { return findValue(value); }
+
+		/**
+		 * Batched lookup, faster than value() for each key on large tables
+		 *
+		 * @param keys to search values
+		 * @return pointer to value of each key, nullptr if not found
+		 */
+		template<class U = K>
+		vector<const V*> values(std::span<const U> keys) const {
+			vector<size_t> pos(keys.size());
+			searchBatch(keys_.data(), keys_.size(), keys, pos.data(),
+						[](const K &x, const U &key) { return x < key; },
+						[](const K &x, const U &key) { return !(key < x); });
+			vector<const V*> ret(keys.size());
+			for (size_t i = 0; i < ret.size(); ++i) ret[i] = pos[i] ? &values_[pos[i] - 1] : nullptr;
+			return ret;
+		}
+
+		template<class U = K>
+		vector<const V*> values(const vector<U> &keys) const { return values(std::span<const U>(keys)); }
+
+		/**
+		 * Batched reverse lookup, faster than key() for each value on large tables
+		 *
+		 * @param values to search keys
+		 * @return pointer to key of each value, nullptr if not found
+		 */
+		template<class U = V>
+		vector<const K*> keys(std::span<const U> values) const {
+			vector<size_t> pos(values.size());
+			searchBatch(rev.data(), rev.size(), values, pos.data(),
+						[this](uint32_t p, const U &value) { return values_[p] < value; },
+						[this](uint32_t p, const U &value) { return !(value < values_[p]); });
+			vector<const K*> ret(values.size());
+			for (size_t i = 0; i < ret.size(); ++i) ret[i] = pos[i] ? &keys_[rev[pos[i] - 1]] : nullptr;
+			return ret;
+		}
+
+		template<class U = V>
+		vector<const K*> keys(const vector<U> &values) const { return keys(std::span<const U>(values)); }
+	};
+
+}
+
+#endif //__HAD_FLATTABLE2_HPP__
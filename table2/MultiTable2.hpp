@@ -0,0 +1,297 @@
+/**
+ * One-to-many Table2
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Associative array (map) that can be indexed by key and by value,
+ * where many keys can have the same value:
+ *   - value(key) is the value of key, as in Table2
+ *   - keys(value) is the contiguous span of all keys with that value,
+ *     sorted (CSR postings: the keys of each value follow the keys of
+ *     the previous value in one array)
+ *   - keyRange(lo, hi) iterates pairs with keys in [lo, hi) and
+ *     valueRange(lo, hi) values in [lo, hi) with their keys, whose keys
+ *     are also one contiguous span
+ *   - three arrays: entries sorted by key, distinct values sorted and the
+ *     postings, one allocation each, instead of one node per entry of
+ *     std::multimap
+ *   - built in O(n log n)
+ *
+ * Table is immutable, it must be fully created with constructor
+ *
+ * Lookups are heterogeneous: any type comparable with K (V) with < can be
+ * searched, e.g. string_view or const char* in a table of strings.
+ */
+
+#ifndef __HAD_MULTITABLE2_HPP__
+#define __HAD_MULTITABLE2_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+namespace had {
+
+	template <class K, class V>
+	class MultiTable2 {
+
+		struct Entry {
+			K key;
+			uint32_t group;     //index in groups of the value of key
+		};
+
+		struct Group {
+			V value;
+			uint32_t first;     //keys of value are postings[first, next group first)
+		};
+
+		vector<Entry> entries;      //sorted by key
+		vector<Group> groups;       //distinct values, sorted
+		vector<K> postings;         //keys grouped by value, sorted in each group
+
+		//keys of groups [first, last)
+		std::span<const K> keysOf(size_t first, size_t last) const {
+			const uint32_t b = first < groups.size() ? groups[first].first : postings.size();
+			const uint32_t e = last < groups.size() ? groups[last].first : postings.size();
+			return { postings.data() + b, postings.data() + e };
+		}
+
+		template<class U>
+		const Entry *lowerKey(const U &key) const {
+			return std::lower_bound(entries.data(), entries.data() + entries.size(), key,
+									[](const Entry &e, const U &k) { return e.key < k; });
+		}
+
+		template<class U>
+		size_t lowerValue(const U &value) const {
+			return std::lower_bound(groups.begin(), groups.end(), value,
+									[](const Group &g, const U &v) { return g.value < v; }) - groups.begin();
+		}
+
+		template<class U>
+		const Entry *findKey(const U &key) const {
+			const Entry *e = lowerKey(key);
+			return e != entries.data() + entries.size() && !(key < e->key) ? e : nullptr;
+		}
+
+		template<class U>
+		size_t findValue(const U &value) const {
+			const size_t g = lowerValue(value);
+			return g < groups.size() && !(value < groups[g].value) ? g : groups.size();
+		}
+
+		/**
+		 * Builds all arrays from pairs in any order
+		 */
+		void build(vector<std::pair<K,V>> &pairs) {
+			if (pairs.size() >= std::numeric_limits<uint32_t>::max())
+				throw std::length_error("MultiTable2: too many entries");
+
+			//by value, then key: groups and postings in one pass
+			std::sort(pairs.begin(), pairs.end(), [](auto &a, auto &b) {
+				return a.second < b.second || (!(b.second < a.second) && a.first < b.first);
+			});
+			size_t distinct = 0;
+			for (size_t i = 0; i < pairs.size(); ++i)
+				distinct += i == 0 || pairs[i - 1].second < pairs[i].second;
+			groups.reserve(distinct);
+			postings.reserve(pairs.size());
+			entries.reserve(pairs.size());
+			for (size_t i = 0; i < pairs.size(); ++i) {
+				//values are moved, compare with the last group
+				if (groups.empty() || groups.back().value < pairs[i].second)
+					groups.push_back({ std::move(pairs[i].second), static_cast<uint32_t>(i) });
+				postings.push_back(pairs[i].first);
+				entries.push_back({ std::move(pairs[i].first), static_cast<uint32_t>(groups.size() - 1) });
+			}
+
+			std::sort(entries.begin(), entries.end(), [](auto &a, auto &b) { return a.key < b.key; });
+			for (size_t i = 1; i < entries.size(); ++i)
+				if (!(entries[i - 1].key < entries[i].key))
+					throw std::invalid_argument("MultiTable2: duplicated key");
+		}
+
+	public:
+
+		/**
+		 * Pairs with keys in a range, in key order
+		 */
+		class KeyRange {
+			const MultiTable2 *t;
+			const Entry *first, *last;
+
+		public:
+			class iterator {
+				const MultiTable2 *t;
+				const Entry *p;
+
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef std::pair<const K&, const V&> value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef void pointer;
+				typedef value_type reference;
+
+				iterator() : t(nullptr), p(nullptr) { }
+				iterator(const MultiTable2 *t, const Entry *p) : t(t), p(p) { }
+
+				reference operator*() const { return { p->key, t->groups[p->group].value }; }
+				iterator &operator++() { ++p; return *this; }
+				iterator operator++(int) { iterator r = *this; ++p; return r; }
+				bool operator==(const iterator &o) const { return p == o.p; }
+			};
+
+			KeyRange(const MultiTable2 *t, const Entry *first, const Entry *last) : t(t), first(first), last(last) { }
+
+			iterator begin() const { return { t, first }; }
+			iterator end() const { return { t, last }; }
+			size_t size() const { return last - first; }
+			bool empty() const { return first == last; }
+		};
+
+		/**
+		 * Distinct values in a range, in value order, each with its keys
+		 */
+		class ValueRange {
+			const MultiTable2 *t;
+			size_t first, last;     //groups
+
+		public:
+			class iterator {
+				const MultiTable2 *t;
+				size_t g;
+
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef std::pair<const V&, std::span<const K>> value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef void pointer;
+				typedef value_type reference;
+
+				iterator() : t(nullptr), g(0) { }
+				iterator(const MultiTable2 *t, size_t g) : t(t), g(g) { }
+
+				reference operator*() const { return { t->groups[g].value, t->keysOf(g, g + 1) }; }
+				iterator &operator++() { ++g; return *this; }
+				iterator operator++(int) { iterator r = *this; ++g; return r; }
+				bool operator==(const iterator &o) const { return g == o.g; }
+			};
+
+			ValueRange(const MultiTable2 *t, size_t first, size_t last) : t(t), first(first), last(last) { }
+
+			iterator begin() const { return { t, first }; }
+			iterator end() const { return { t, last }; }
+			//distinct values
+			size_t size() const { return last - first; }
+			bool empty() const { return first == last; }
+
+			/**
+			 * @return keys of all values in range, contiguous, grouped by value
+			 */
+			std::span<const K> keys() const { return t->keysOf(first, last); }
+		};
+
+		/**
+		 * @param m map<K,V> that represents the table Keys and Values,
+		 *        values may be duplicated
+		 */
+		MultiTable2(const map<K,V> &m) {
+			vector<std::pair<K,V>> pairs(m.begin(), m.end());
+			build(pairs);
+		}
+
+		/**
+		 * @param pairs key, value pairs in any order, values may be duplicated
+		 * @throws invalid_argument if there are duplicated keys
+		 */
+		MultiTable2(vector<std::pair<K,V>> pairs) { build(pairs); }
+
+		/**
+		 * @param first, last range of key, value pairs in any order
+		 * @throws invalid_argument if there are duplicated keys
+		 */
+		template<class It>
+		MultiTable2(It first, It last) {
+			vector<std::pair<K,V>> pairs(first, last);
+			build(pairs);
+		}
+
+		/**
+		 * @return number of key, value pairs in table
+		 */
+		int size() const { return entries.size(); }
+
+		/**
+		 * @return number of distinct values in table
+		 */
+		int valueCount() const { return groups.size(); }
+
+		/**
+		 * @param key to search value
+		 * @return value at key
+		 */
+		template<class U = K>
+		const V& value(const U &key) const {
+			const Entry *e = findKey(key);
+			if (!e) throw std::out_of_range("MultiTable2: key not found");
+			return groups[e->group].value;
+		}
+
+		/**
+		 * @param value to search keys
+		 * @return all keys with value, sorted, empty if value is not in table
+		 */
+		template<class U = V>
+		std::span<const K> keys(const U &value) const {
+			const size_t g = findValue(value);
+			return keysOf(g, g + 1);
+		}
+
+		/**
+		 * @return true if key is in table
+		 */
+		template<class U = K>
+		bool containsKey(const U &key) const { return findKey(key); }
+
+		/**
+		 * @return true if value is in table
+		 */
+		template<class U = V>
+		bool containsValue(const U &value) const { return findValue(value) != groups.size(); }
+
+		/**
+		 * @return pairs with keys in [lo, hi)
+		 */
+		template<class L = K, class H = L>
+		KeyRange keyRange(const L &lo, const H &hi) const {
+			const Entry *first = lowerKey(lo);
+			return KeyRange(this, first, std::max(first, lowerKey(hi)));
+		}
+
+		/**
+		 * @return distinct values in [lo, hi) with their keys
+		 */
+		template<class L = V, class H = L>
+		ValueRange valueRange(const L &lo, const H &hi) const {
+			const size_t first = lowerValue(lo);
+			return ValueRange(this, first, std::max(first, lowerValue(hi)));
+		}
+
+		/**
+		 * All pairs, in key order
+		 */
+		typename KeyRange::iterator begin() const { return { this, entries.data() }; }
+		typename KeyRange::iterator end() const { return { this, entries.data() + entries.size() }; }
+	};
+
+}
+
+#endif //__HAD_MULTITABLE2_HPP__
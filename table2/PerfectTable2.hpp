@@ -0,0 +1,389 @@
+/**
+ * Perfect hash Table2 of strings
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Associative array of strings that can be indexed by key and by value,
+ * for large static dictionaries:
+ *   - one minimal perfect hash function (MPHF) for keys and one for values,
+ *     hash and displace (CHD / PTHash style): keys are hashed into buckets
+ *     of about 4 keys, each bucket stores the pilot that moves all its keys
+ *     to free slots; 32 bit pilots are 8 bits per key
+ *   - strings are stored in one arena, entries are offsets and lengths
+ *   - lookups are O(1): one hash, one pilot, one entry and a single string
+ *     compare to reject strings not in the table
+ *
+ * PerfectTable2 builds the table at runtime from a map and owns its data.
+ * View queries data it does not own, e.g. the arrays of a generated header
+ * (writeHeader()) or of a memory mapped image.
+ *
+ * Table must have a relationship one-to-one
+ *
+ * Ref: Belazzougui et al., "Hash, displace, and compress", 2009
+ *      Pibiri, Trani, "PTHash: revisiting FCH minimal perfect hashing", 2021
+ */
+
+#ifndef __HAD_PERFECTTABLE2_HPP__
+#define __HAD_PERFECTTABLE2_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::map;
+using std::ostream;
+using std::string;
+using std::string_view;
+using std::vector;
+
+namespace had {
+
+	class PerfectTable2 {
+	public:
+		struct Entry {
+			uint32_t keyOffset, keyLength;
+			uint32_t valueOffset, valueLength;
+		};
+
+		/**
+		 * Minimal perfect hash function of one direction
+		 */
+		struct Hash {
+			uint64_t seed = 0;
+			uint32_t buckets = 0;
+			uint32_t n = 0;
+			const uint32_t *pilots = nullptr;
+
+			static uint64_t mix(uint64_t a, uint64_t b) {
+				const __uint128_t r = static_cast<__uint128_t>(a) * b;
+				return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+			}
+
+			//64 bit string hash, 8 bytes per step
+			static uint64_t hash(string_view s, uint64_t seed) {
+				const char *p = s.data();
+				size_t len = s.size();
+				uint64_t h = mix(seed ^ 0x9E3779B97F4A7C15ull, len ^ 0xBF58476D1CE4E5B9ull);
+				for (; len >= 8; p += 8, len -= 8) {
+					uint64_t k;
+					std::memcpy(&k, p, 8);
+					h = mix(h ^ k, 0x94D049BB133111EBull);
+				}
+				uint64_t k = 0;
+				std::memcpy(&k, p, len);
+				return mix(h ^ k, 0x2545F4914F6CDD1Dull);
+			}
+
+			//[0, n) from 64 bits, without division
+			static uint32_t range(uint64_t h, uint32_t n) {
+				return static_cast<uint32_t>((static_cast<__uint128_t>(h) * n) >> 64);
+			}
+
+			static uint32_t bucket(uint64_t h, uint32_t buckets) { return range(h, buckets); }
+
+			static uint32_t position(uint64_t h, uint32_t pilot, uint32_t n) {
+				return range(mix(h, 2 * static_cast<uint64_t>(pilot) + 0x9E3779B97F4A7C15ull), n);
+			}
+
+			/**
+			 * @return slot of s in [0, n), any slot if s is not one of the hashed strings
+			 */
+			uint32_t operator()(string_view s) const {
+				const uint64_t h = hash(s, seed);
+				return position(h, pilots[bucket(h, buckets)], n);
+			}
+		};
+
+		/**
+		 * Queries a table in memory it does not own
+		 *   entries: in slot order of the key hash
+		 *   reverse: entry of each slot of the value hash
+		 */
+		class View {
+			Hash keyHash, valueHash;
+			const Entry *entries = nullptr;
+			const uint32_t *reverse = nullptr;
+			const char *arena = nullptr;
+			uint32_t n = 0;
+
+			string_view keyOf(const Entry &e) const { return { arena + e.keyOffset, e.keyLength }; }
+			string_view valueOf(const Entry &e) const { return { arena + e.valueOffset, e.valueLength }; }
+
+			const Entry *findKey(string_view key) const {
+				if (n == 0) return nullptr;
+				const Entry &e = entries[keyHash(key)];
+				return keyOf(e) == key ? &e : nullptr;
+			}
+
+			const Entry *findValue(string_view value) const {
+				if (n == 0) return nullptr;
+				const Entry &e = entries[reverse[valueHash(value)]];
+				return valueOf(e) == value ? &e : nullptr;
+			}
+
+		public:
+			constexpr View() = default;
+			constexpr View(const Hash &keyHash, const Hash &valueHash, const Entry *entries,
+						   const uint32_t *reverse, const char *arena, uint32_t n)
+					: keyHash(keyHash), valueHash(valueHash), entries(entries), reverse(reverse), arena(arena), n(n) { }
+
+			/**
+			 * @return number of key, value pairs in table
+			 */
+			int size() const { return n; }
+
+			/**
+			 * @param key to search value
+			 * @return value at key, in the table memory
+			 */
+			string_view value(string_view key) const {
+				const Entry *e = findKey(key);
+				if (!e) throw std::out_of_range("PerfectTable2: key not found");
+				return valueOf(*e);
+			}
+
+			/**
+			 * @param value to search key
+			 * @return key at value, in the table memory
+			 */
+			string_view key(string_view value) const {
+				const Entry *e = findValue(value);
+				if (!e) throw std::out_of_range("PerfectTable2: value not found");
+				return keyOf(*e);
+			}
+
+			bool containsKey(string_view key) const { return findKey(key); }
+			bool containsValue(string_view value) const { return findValue(value); }
+
+			/**
+			 * @return i-th pair in slot order, for iteration
+			 */
+			std::pair<string_view, string_view> operator[](uint32_t i) const {
+				return { keyOf(entries[i]), valueOf(entries[i]) };
+			}
+		};
+
+		//average keys per bucket
+		static constexpr double lambda = 4.0;
+
+	private:
+		Hash keyHash, valueHash;
+		vector<uint32_t> keyPilots, valuePilots;
+		vector<Entry> entries;
+		vector<uint32_t> reverse;
+		string arena;
+
+		/**
+		 * Builds MPHF of strings into h and pilots
+		 * @return slot of each string
+		 */
+		static vector<uint32_t> build(const vector<string_view> &strings, Hash &h, vector<uint32_t> &pilots) {
+			const uint32_t n = strings.size();
+			h.n = n;
+			h.buckets = std::max<uint32_t>(1, static_cast<uint32_t>(n / lambda) + 1);
+			vector<uint64_t> hashes(n);
+			vector<uint32_t> slots(n);
+
+			for (uint64_t attempt = 0; attempt < 16; ++attempt) {
+				h.seed = Hash::mix(attempt + 1, 0x9E3779B97F4A7C15ull);
+				for (uint32_t i = 0; i < n; ++i) hashes[i] = Hash::hash(strings[i], h.seed);
+
+				//strings of each bucket, counting sort
+				vector<uint32_t> start(h.buckets + 1, 0), members(n);
+				for (uint32_t i = 0; i < n; ++i) ++start[Hash::bucket(hashes[i], h.buckets) + 1];
+				for (uint32_t b = 0; b < h.buckets; ++b) start[b + 1] += start[b];
+				vector<uint32_t> fill(start.begin(), start.end() - 1);
+				for (uint32_t i = 0; i < n; ++i) members[fill[Hash::bucket(hashes[i], h.buckets)]++] = i;
+
+				//largest buckets first, while there are many free slots
+				vector<uint32_t> order(h.buckets);
+				for (uint32_t b = 0; b < h.buckets; ++b) order[b] = b;
+				std::stable_sort(order.begin(), order.end(),
+								 [&start](uint32_t a, uint32_t b) { return start[a + 1] - start[a] > start[b + 1] - start[b]; });
+
+				//expected tries of the last bucket are about n
+				const uint64_t maxPilot = std::min<uint64_t>(64ull * n + (1 << 20), std::numeric_limits<uint32_t>::max());
+				pilots.assign(h.buckets, 0);
+				vector<bool> taken(n, false);
+				vector<uint32_t> pos;
+				bool ok = true;
+				for (uint32_t b : order) {
+					const uint32_t first = start[b], size = start[b + 1] - first;
+					if (size == 0) break;
+					uint32_t pilot = 0;
+					for (;; ++pilot) {
+						pos.clear();
+						bool free = true;
+						for (uint32_t j = 0; j < size && free; ++j) {
+							const uint32_t p = Hash::position(hashes[members[first + j]], pilot, n);
+							free = !taken[p] && std::find(pos.begin(), pos.end(), p) == pos.end();
+							pos.push_back(p);
+						}
+						if (free) break;
+						//equal hashes in a bucket never fit, try another seed
+						if (pilot == maxPilot) {
+							ok = false;
+							break;
+						}
+					}
+					if (!ok) break;
+					pilots[b] = pilot;
+					for (uint32_t j = 0; j < size; ++j) {
+						taken[pos[j]] = true;
+						slots[members[first + j]] = pos[j];
+					}
+				}
+				if (ok) {
+					h.pilots = pilots.data();
+					return slots;
+				}
+			}
+			throw std::invalid_argument("PerfectTable2: duplicated strings");
+		}
+
+		static void writeArray(ostream &os, const string &type, const string &name, const vector<uint32_t> &a) {
+			os << "inline constexpr " << type << " " << name << "[] = {";
+			for (size_t i = 0; i < a.size(); ++i) os << (i % 16 ? " " : "\n\t") << a[i] << ",";
+			//no zero length arrays
+			if (a.empty()) os << "0";
+			os << "\n};\n\n";
+		}
+
+	public:
+		/**
+		 * @param m map<string,string> that represents the table Keys and Values
+		 * @throws invalid_argument if m has duplicated values
+		 * @throws length_error if strings do not fit 32 bit offsets
+		 */
+		PerfectTable2(const map<string, string> &m) {
+			size_t bytes = 0;
+			for (const auto &[k, v] : m) bytes += k.size() + v.size();
+			if (bytes > std::numeric_limits<uint32_t>::max() || m.size() > std::numeric_limits<uint32_t>::max())
+				throw std::length_error("PerfectTable2: table too large");
+
+			vector<string_view> keys, values;
+			keys.reserve(m.size());
+			values.reserve(m.size());
+			for (const auto &[k, v] : m) {
+				keys.push_back(k);
+				values.push_back(v);
+			}
+			{
+				vector<string_view> sorted = values;
+				std::sort(sorted.begin(), sorted.end());
+				if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+					throw std::invalid_argument("PerfectTable2: duplicated value");
+			}
+			const vector<uint32_t> keySlot = build(keys, keyHash, keyPilots);
+			const vector<uint32_t> valueSlot = build(values, valueHash, valuePilots);
+
+			//entries in key slot order, strings in arena in the same order
+			vector<uint32_t> bySlot(m.size());
+			for (uint32_t i = 0; i < m.size(); ++i) bySlot[keySlot[i]] = i;
+			arena.reserve(bytes);
+			entries.resize(m.size());
+			reverse.resize(m.size());
+			for (uint32_t s = 0; s < m.size(); ++s) {
+				const uint32_t i = bySlot[s];
+				Entry &e = entries[s];
+				e.keyOffset = arena.size();
+				e.keyLength = keys[i].size();
+				arena += keys[i];
+				e.valueOffset = arena.size();
+				e.valueLength = values[i].size();
+				arena += values[i];
+				reverse[valueSlot[i]] = s;
+			}
+		}
+
+		//views point to own data
+		PerfectTable2(const PerfectTable2 &) = delete;
+		PerfectTable2 &operator=(const PerfectTable2 &) = delete;
+
+		View view() const {
+			Hash k = keyHash, v = valueHash;
+			k.pilots = keyPilots.data();
+			v.pilots = valuePilots.data();
+			return View(k, v, entries.data(), reverse.data(), arena.data(), entries.size());
+		}
+
+		int size() const { return entries.size(); }
+		string_view value(string_view key) const { return view().value(key); }
+		string_view key(string_view value) const { return view().key(value); }
+		bool containsKey(string_view key) const { return view().containsKey(key); }
+		bool containsValue(string_view value) const { return view().containsValue(value); }
+
+		/**
+		 * Raw data, to serialize the table
+		 */
+		const Hash &keyFunction() const { return keyHash; }
+		const Hash &valueFunction() const { return valueHash; }
+		std::span<const uint32_t> keyPilotData() const { return keyPilots; }
+		std::span<const uint32_t> valuePilotData() const { return valuePilots; }
+		std::span<const Entry> entryData() const { return entries; }
+		std::span<const uint32_t> reverseData() const { return reverse; }
+		const string &arenaData() const { return arena; }
+
+		/**
+		 * @return bytes used by hash functions, excluding entries and strings
+		 */
+		size_t hashBytes() const { return (keyPilots.size() + valuePilots.size()) * sizeof(uint32_t); }
+
+		/**
+		 * Writes a C++ header with the table as constant data, no build at startup:
+		 *     #include "names.hpp"
+		 *     names.value("key");     //names is a PerfectTable2::View
+		 *
+		 * @param name of the View variable, prefix of the arrays
+		 */
+		void writeHeader(ostream &os, const string &name) const {
+			os << "//Generated by had::PerfectTable2::writeHeader(), do not edit\n\n"
+			   << "#pragma once\n\n#include <table2/PerfectTable2.hpp>\n\n";
+			writeArray(os, "uint32_t", name + "_keyPilots", keyPilots);
+			writeArray(os, "uint32_t", name + "_valuePilots", valuePilots);
+			writeArray(os, "uint32_t", name + "_reverse", reverse);
+
+			os << "inline constexpr had::PerfectTable2::Entry " << name << "_entries[] = {";
+			for (size_t i = 0; i < entries.size(); ++i) {
+				const Entry &e = entries[i];
+				os << (i % 4 ? " " : "\n\t") << "{" << e.keyOffset << "," << e.keyLength << ","
+				   << e.valueOffset << "," << e.valueLength << "},";
+			}
+			if (entries.empty()) os << "{}";
+			os << "\n};\n\n";
+
+			//octal escapes: always 3 digits, so next chars are never part of them
+			os << "inline constexpr char " << name << "_arena[] =";
+			for (size_t i = 0; i < arena.size(); ++i) {
+				if (i % 64 == 0) os << "\n\t\"";
+				const unsigned char c = arena[i];
+				if (c == '"' || c == '\\') os << '\\' << c;
+				else if (c >= 32 && c < 127 && c != '?') os << c;
+				else os << '\\' << std::oct << std::setw(3) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+				if (i % 64 == 63 || i + 1 == arena.size()) os << "\"";
+			}
+			if (arena.empty()) os << " \"\"";
+			os << ";\n\n";
+
+			auto hash = [&os](const Hash &h, const string &pilots) {
+				os << "had::PerfectTable2::Hash{ " << h.seed << "ull, " << h.buckets << ", " << h.n << ", " << pilots << " }";
+			};
+			os << "inline constexpr had::PerfectTable2::View " << name << "(\n\t";
+			hash(keyHash, name + "_keyPilots");
+			os << ",\n\t";
+			hash(valueHash, name + "_valuePilots");
+			os << ",\n\t" << name << "_entries, " << name << "_reverse, " << name << "_arena, " << entries.size() << ");\n";
+		}
+	};
+
+}
+
+#endif //__HAD_PERFECTTABLE2_HPP__
@@ -7,12 +7,22 @@
  *
  * Table  must have a relationship ont-to-one
  * duplicated values will NOT be accessed by value
+ *
+ * Lookups are heterogeneous: e.g. string_view or const char* can be
+ * searched in tables of strings, in both directions, without allocation
  */
 
 #ifndef __HAD_TABLE2_HPP__
 #define __HAD_TABLE2_HPP__
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 using std::map;
 
@@ -21,30 +31,40 @@ namespace had {
 	template <class K, class V>
 	class Table2 {
 
-		map<K,V> table;
-
 		/**
-		 * Reverse table is done with pointers to original map keys and values.
-		 * It is needed a custom comparator, to compare the pointed keys
-		 * or it will only match the same object and NOT equal objects
-		 *
-		 * Maps are constant so there is no way of deleting	from table map
-		 * and leave pointers to nowhere in tablerev
-		 * (Also parameter map is copied)
-		 *
-		 * Note: using std::multimap would allow duplicate keys and values
-		 *       to be reverted
-		 *       As it is, duplicated values will be lost in reverseMap
+		 * Both directions are one array each:
+		 *   - table: key, value pairs sorted by key
+		 *   - tablerev: positions in table sorted by value, then by key
+		 * Lookups are binary searches with any type comparable with K (V)
 		 *
-		 * Note: C++ does not accept maps of references
+		 * Note: for duplicated values only the last key is found,
+		 *       MultiTable2 returns all keys of a value
 		 */
-		template<class T> struct prtComparator {
-			bool operator()(const T* lhs, const T* rhs) const {
-				return *lhs < *rhs;
-			}
-		};
-		map<const V*,const K*,prtComparator<V>> tablerev;
+		std::vector<std::pair<K,V>> table;
+		std::vector<uint32_t> tablerev;
 
+		void reverse() {
+			if (table.size() >= std::numeric_limits<uint32_t>::max())
+				throw std::length_error("Table2: too many entries");
+			tablerev.resize(table.size());
+			for (uint32_t i = 0; i < tablerev.size(); ++i) tablerev[i] = i;
+			auto less = [this](uint32_t a, uint32_t b) { return table[a].second < table[b].second; };
+			//O(n) if values increase with keys, else stable: ties of values stay in key order.
+			//Merge sort also uses the runs of partly ordered values, much faster than std::sort here
+			if (!std::is_sorted(tablerev.begin(), tablerev.end(), less))
+				std::stable_sort(tablerev.begin(), tablerev.end(), less);
+		}
+
+		//pairs appended to table: sorted by key, keeps the first of duplicated keys
+		void sortKeys() {
+			auto less = [](const std::pair<K,V> &a, const std::pair<K,V> &b) { return a.first < b.first; };
+			if (!std::is_sorted(table.begin(), table.end(), less))
+				std::stable_sort(table.begin(), table.end(), less);
+			table.erase(std::unique(table.begin(), table.end(),
+									[](const auto &a, const auto &b) { return !(a.first < b.first); }),
+						table.end());
+			reverse();
+		}
 
 	public:
 
@@ -52,34 +72,77 @@ namespace had {
 		 * @param table map<K,V> that represents the table Keys and Values
 		 * @pre   m must not have duplicated values
 		 */
-		Table2(const map<K,V> &m) : table(m) {
-			//create reverse table of pointers
-			typename map<K, V>::iterator it;
-			for (it = table.begin(); it != table.end(); ++it) {
-				//pointer version of: tablerev[it->second] = it->first;
-				const K *k = &(it->first);
-				const V *v = &(it->second);
-				tablerev[v] = k;
+		Table2(const map<K,V> &m) : table(m.begin(), m.end()) { reverse(); }
+
+		/**
+		 * Moves keys and values of the map into the table, none is copied
+		 *
+		 * @param table map<K,V> that represents the table Keys and Values, left empty
+		 * @pre   m must not have duplicated values
+		 */
+		Table2(map<K,V> &&m) {
+			table.reserve(m.size());
+			while (!m.empty()) {
+				auto node = m.extract(m.begin());
+				table.emplace_back(std::move(node.key()), std::move(node.mapped()));
 			}
+			reverse();
 		}
 
+		/**
+		 * @param first, last range of key, value pairs, O(n) if sorted by key
+		 * @pre   range must not have duplicated values,
+		 *        for duplicated keys only the first is kept
+		 */
+		template<class It>
+		Table2(It first, It last) : table(first, last) { sortKeys(); }
+
 		/**
 		 * @return number of key, value pairs in table
 		 */
 		int size() const { return table.size(); }
 
 		/**
-		 * @param key to search value
+		 * Key, value pairs in key order
+		 */
+		auto begin() const { return table.begin(); }
+		auto end() const { return table.end(); }
+
+		/**
+		 * @return true if no value is duplicated, O(n)
+		 */
+		bool oneToOne() const {
+			return std::adjacent_find(tablerev.begin(), tablerev.end(),
+									  [this](uint32_t a, uint32_t b) { return !(table[a].second < table[b].second); }) == tablerev.end();
+		}
+
+		/**
+		 * @param key to search value, any type comparable with K,
+		 *        e.g. string_view or const char* for string keys, without allocation
 		 * @return value at key
 		 */
-		const V& value(const K key) const { return table.at(key); }
+		template<class U = K>
+		const V& value(const U &key) const {
+			const auto it = std::lower_bound(table.begin(), table.end(), key,
+											 [](const std::pair<K,V> &e, const U &k) { return e.first < k; });
+			if (it == table.end() || key < it->first) throw std::out_of_range("Table2: key not found");
+			return it->second;
+		}
 
 		/**
-		 * @param value to search key
+		 * @param value to search key, any type comparable with V,
+		 *        e.g. string_view or const char* for string values, without allocation
 		 * @return key at value
 		 */
-		//const K& key(V value) const { return *tablerev.at(value); }
-		const K& key(const V value) const { return *tablerev.at(&value); }
+		template<class U = V>
+		const K& key(const U &value) const {
+			//last of equal values, as when the reverse table was a map
+			const auto it = std::upper_bound(tablerev.begin(), tablerev.end(), value,
+											 [this](const U &v, uint32_t i) { return v < table[i].second; });
+			if (it == tablerev.begin() || table[*std::prev(it)].second < value)
+				throw std::out_of_range("Table2: value not found");
+			return table[*std::prev(it)].first;
+		}
 	};
 
 }
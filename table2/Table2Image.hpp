@@ -0,0 +1,412 @@
+/**
+ * Binary image of a Table2
+ * hdaniel@ualg.pt 2026 oct
+ *
+ * Table2 saved to a file that is memory mapped and queried in place,
+ * no build nor allocations at startup:
+ *   - the image is the PerfectTable2 layout: hash functions of keys and
+ *     values, entries and string arena, each section 8 byte aligned
+ *   - sections are located by offsets from the start of the image,
+ *     so it is position independent
+ *   - a versioned header checks magic, version, byte order and the key
+ *     and value types, and a 64 bit checksum checks the contents
+ *   - the file is mapped read only and shared: processes that map the
+ *     same image share its page cache memory
+ *
+ * K and V are std::string or trivially copyable types with unique
+ * object representations (integers, enums), stored as their bytes.
+ * string keys and values are returned as string_view into the image.
+ *
+ * Use it as:
+ *     Table2Image<int, string>::write("names.t2i", m);    //offline
+ *     Table2Image<int, string> names("names.t2i");        //at startup
+ *     string_view name = names.value(42);
+ *
+ * write() replaces the file atomically, processes that mapped the old
+ * image keep using it until they open it again. The image is written to
+ * a unique temporary file in the same directory, synced, renamed to the
+ * path and the directory synced: concurrent writers do not mix images,
+ * and after a crash the path has the old or the new image, complete.
+ */
+
+#ifndef __HAD_TABLE2IMAGE_HPP__
+#define __HAD_TABLE2IMAGE_HPP__
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include "PerfectTable2.hpp"
+#include "Table2.hpp"
+
+using std::map;
+using std::string;
+using std::string_view;
+
+namespace had {
+
+	/**
+	 * Bytes of keys and values in the image
+	 */
+	template <class T>
+	struct Table2ImageCodec {
+		static_assert(std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>,
+					  "Table2Image: type must be std::string or an integral or enum type");
+		typedef T Ref;
+		static constexpr uint32_t size = sizeof(T);     //0 for strings
+
+		static string_view encode(const T &x) { return { reinterpret_cast<const char*>(&x), sizeof(T) }; }
+		static T decode(string_view s) {
+			T x;
+			std::memcpy(&x, s.data(), sizeof(T));
+			return x;
+		}
+	};
+
+	template <>
+	struct Table2ImageCodec<string> {
+		typedef string_view Ref;
+		static constexpr uint32_t size = 0;
+
+		static string_view encode(string_view s) { return s; }
+		static string_view decode(string_view s) { return s; }
+	};
+
+
+	template <class K, class V>
+	class Table2Image {
+		typedef Table2ImageCodec<K> KeyCodec;
+		typedef Table2ImageCodec<V> ValueCodec;
+		typedef PerfectTable2::Entry Entry;
+
+	public:
+		typedef typename KeyCodec::Ref KeyRef;
+		typedef typename ValueCodec::Ref ValueRef;
+		//lookup arguments, string_view for strings
+		typedef std::conditional_t<KeyCodec::size != 0, K, string_view> KeyArg;
+		typedef std::conditional_t<ValueCodec::size != 0, V, string_view> ValueArg;
+
+		static constexpr uint32_t version = 1;
+
+		struct Header {
+			char magic[8];
+			uint32_t version;
+			uint32_t byteOrder;
+			uint64_t size;                      //bytes of image, header included
+			uint64_t checksum;                  //of the bytes after the header
+			uint32_t n;
+			uint32_t keySize, valueSize;        //0 for strings
+			uint32_t keyBuckets, valueBuckets;
+			uint32_t reserved;
+			uint64_t keySeed, valueSeed;
+			uint64_t keyPilots, valuePilots;    //section offsets
+			uint64_t entries, reverse, arena;
+			uint64_t arenaSize;
+		};
+
+	private:
+		static constexpr char magic[8] = { 'H', 'A', 'D', 'T', 'B', 'L', '2', '\0' };
+		static constexpr uint32_t byteOrder = 0x01020304;
+		static constexpr uint64_t checksumSeed = 0x7461626C6532ull;
+
+		const char *base = nullptr;
+		size_t length = 0;
+		bool mapped = false;
+		PerfectTable2::View view_;
+
+		static uint64_t checksum(const char *image, size_t size) {
+			return PerfectTable2::Hash::hash(string_view(image + sizeof(Header), size - sizeof(Header)), checksumSeed);
+		}
+
+		[[noreturn]] static void invalid(const string &what) {
+			throw std::runtime_error("Table2Image: " + what);
+		}
+
+		/**
+		 * Checks the image and creates the view of its sections
+		 */
+		void attach(bool verify) {
+			if (length < sizeof(Header)) invalid("truncated image");
+			if (reinterpret_cast<uintptr_t>(base) % alignof(uint64_t)) invalid("image not 8 byte aligned");
+			Header h;
+			std::memcpy(&h, base, sizeof(Header));
+			if (std::memcmp(h.magic, magic, sizeof(magic))) invalid("not a Table2 image");
+			if (h.version != version) invalid("unsupported version " + std::to_string(h.version));
+			if (h.byteOrder != byteOrder) invalid("byte order differs");
+			if (h.keySize != KeyCodec::size || h.valueSize != ValueCodec::size) invalid("key or value type differs");
+			if (h.size != length) invalid("size differs from header");
+
+			auto section = [&](uint64_t offset, uint64_t count, size_t size) {
+				if (offset % alignof(uint64_t) || offset < sizeof(Header) || offset > length
+					|| count > (length - offset) / size)
+					invalid("section out of image");
+				return base + offset;
+			};
+			const auto *keyPilots = reinterpret_cast<const uint32_t*>(section(h.keyPilots, h.keyBuckets, sizeof(uint32_t)));
+			const auto *valuePilots = reinterpret_cast<const uint32_t*>(section(h.valuePilots, h.valueBuckets, sizeof(uint32_t)));
+			const auto *entries = reinterpret_cast<const Entry*>(section(h.entries, h.n, sizeof(Entry)));
+			const auto *reverse = reinterpret_cast<const uint32_t*>(section(h.reverse, h.n, sizeof(uint32_t)));
+			const char *arena = section(h.arena, h.arenaSize, 1);
+			if (h.n && (!h.keyBuckets || !h.valueBuckets)) invalid("no hash buckets");
+
+			if (verify) {
+				if (checksum(base, length) != h.checksum) invalid("checksum mismatch");
+				//a valid checksum does not mean it was written by write()
+				for (uint32_t i = 0; i < h.n; ++i) {
+					const Entry &e = entries[i];
+					if (reverse[i] >= h.n || e.keyOffset > h.arenaSize || e.keyLength > h.arenaSize - e.keyOffset
+						|| e.valueOffset > h.arenaSize || e.valueLength > h.arenaSize - e.valueOffset)
+						invalid("entry out of arena");
+					if ((KeyCodec::size && e.keyLength != KeyCodec::size)
+						|| (ValueCodec::size && e.valueLength != ValueCodec::size))
+						invalid("entry size differs from type");
+				}
+			}
+
+			const PerfectTable2::Hash keyHash { h.keySeed, h.keyBuckets, h.n, keyPilots };
+			const PerfectTable2::Hash valueHash { h.valueSeed, h.valueBuckets, h.n, valuePilots };
+			view_ = PerfectTable2::View(keyHash, valueHash, entries, reverse, arena, h.n);
+		}
+
+		void release() {
+			if (mapped && base) munmap(const_cast<char*>(base), length);
+			base = nullptr;
+			length = 0;
+			mapped = false;
+		}
+
+		/**
+		 * @return image of m, sections after the header in the order of its fields
+		 */
+		static string image(const map<K,V> &m) {
+			map<string, string> bytes;
+			for (const auto &[k, v] : m)
+				bytes.emplace(string(KeyCodec::encode(k)), string(ValueCodec::encode(v)));
+			const PerfectTable2 t(bytes);
+
+			Header h {};
+			std::memcpy(h.magic, magic, sizeof(magic));
+			h.version = version;
+			h.byteOrder = byteOrder;
+			h.n = t.size();
+			h.keySize = KeyCodec::size;
+			h.valueSize = ValueCodec::size;
+			h.keyBuckets = t.keyFunction().buckets;
+			h.valueBuckets = t.valueFunction().buckets;
+			h.keySeed = t.keyFunction().seed;
+			h.valueSeed = t.valueFunction().seed;
+
+			string out(sizeof(Header), '\0');
+			auto append = [&out](const void *data, size_t size) {
+				out.resize((out.size() + 7) & ~size_t(7), '\0');
+				const uint64_t offset = out.size();
+				out.append(static_cast<const char*>(data), size);
+				return offset;
+			};
+			h.keyPilots = append(t.keyPilotData().data(), t.keyPilotData().size_bytes());
+			h.valuePilots = append(t.valuePilotData().data(), t.valuePilotData().size_bytes());
+			h.entries = append(t.entryData().data(), t.entryData().size_bytes());
+			h.reverse = append(t.reverseData().data(), t.reverseData().size_bytes());
+			h.arena = append(t.arenaData().data(), t.arenaData().size());
+			h.arenaSize = t.arenaData().size();
+			out.resize((out.size() + 7) & ~size_t(7), '\0');
+
+			h.size = out.size();
+			h.checksum = checksum(out.data(), out.size());
+			std::memcpy(out.data(), &h, sizeof(Header));
+			return out;
+		}
+
+	public:
+
+		/**
+		 * Maps an image file, read only and shared
+		 *
+		 * @param verify checks checksum and entries, O(size of image),
+		 *        without it only the header is read at startup
+		 * @throws runtime_error if the file cannot be mapped or is not a valid image
+		 */
+		explicit Table2Image(const string &path, bool verify = true) {
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) invalid("cannot open " + path + ": " + std::strerror(errno));
+			struct stat st;
+			if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+				::close(fd);
+				invalid("truncated image " + path);
+			}
+			void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);    //mapping keeps the file
+			if (p == MAP_FAILED) invalid("cannot map " + path + ": " + std::strerror(errno));
+			base = static_cast<const char*>(p);
+			length = st.st_size;
+			mapped = true;
+			try {
+				attach(verify);
+			} catch (...) {
+				release();
+				throw;
+			}
+		}
+
+		//a string literal is a path, not the bytes of an image
+		explicit Table2Image(const char *path, bool verify = true) : Table2Image(string(path), verify) { }
+
+		/**
+		 * Queries an image in memory it does not own, e.g. embedded in the
+		 * executable or read from a socket
+		 *
+		 * @param bytes image, 8 byte aligned, must outlive the table
+		 */
+		explicit Table2Image(std::span<const char> bytes, bool verify = true)
+				: base(bytes.data()), length(bytes.size()) { attach(verify); }
+
+		Table2Image(const Table2Image &) = delete;
+		Table2Image &operator=(const Table2Image &) = delete;
+
+		Table2Image(Table2Image &&other) noexcept
+				: base(std::exchange(other.base, nullptr)), length(std::exchange(other.length, 0)),
+				  mapped(std::exchange(other.mapped, false)), view_(other.view_) { }
+
+		Table2Image &operator=(Table2Image &&other) noexcept {
+			if (this != &other) {
+				release();
+				base = std::exchange(other.base, nullptr);
+				length = std::exchange(other.length, 0);
+				mapped = std::exchange(other.mapped, false);
+				view_ = other.view_;
+			}
+			return *this;
+		}
+
+		~Table2Image() { release(); }
+
+		/**
+		 * Writes the image of m
+		 *
+		 * @throws invalid_argument if m has duplicated values
+		 */
+		static void write(std::ostream &os, const map<K,V> &m) {
+			const string out = image(m);
+			os.write(out.data(), out.size());
+		}
+
+		/**
+		 * Writes the image of m to a temporary file renamed to path,
+		 * with permissions rw-r--r--
+		 *
+		 * @throws invalid_argument if m has duplicated values
+		 * @throws runtime_error if the file cannot be written
+		 */
+		static void write(const string &path, const map<K,V> &m) {
+			const string out = image(m);
+			string tmp = path + ".XXXXXX";
+			const int fd = mkstemp(tmp.data());
+			if (fd < 0) invalid("cannot create " + tmp + ": " + std::strerror(errno));
+			auto fail = [&](const string &what) {
+				const string error = std::strerror(errno);
+				::close(fd);
+				::unlink(tmp.c_str());
+				invalid(what + ": " + error);
+			};
+			for (size_t done = 0; done < out.size();) {
+				const ssize_t n = ::write(fd, out.data() + done, out.size() - done);
+				if (n < 0 && errno == EINTR) continue;
+				if (n < 0) fail("cannot write " + tmp);
+				done += n;
+			}
+			//mkstemp creates it rw-------
+			if (fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) < 0) fail("cannot chmod " + tmp);
+			//contents on disk before the name points to them
+			if (fsync(fd) < 0) fail("cannot sync " + tmp);
+			if (::close(fd) < 0) {
+				const string error = std::strerror(errno);
+				::unlink(tmp.c_str());
+				invalid("cannot write " + tmp + ": " + error);
+			}
+			if (std::rename(tmp.c_str(), path.c_str())) {
+				const string error = std::strerror(errno);
+				::unlink(tmp.c_str());
+				invalid("cannot rename " + tmp + " to " + path + ": " + error);
+			}
+			//the rename on disk
+			const size_t slash = path.rfind('/');
+			const string dir = slash == string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+			const int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (dfd < 0) invalid("cannot open " + dir + ": " + std::strerror(errno));
+			const int synced = fsync(dfd);
+			const string error = std::strerror(errno);
+			::close(dfd);
+			if (synced < 0) invalid("cannot sync " + dir + ": " + error);
+		}
+
+		static void write(const string &path, const Table2<K,V> &t) { write(path, map<K,V>(t.begin(), t.end())); }
+
+		/**
+		 * @return number of key, value pairs in table
+		 */
+		int size() const { return view_.size(); }
+
+		/**
+		 * @param key to search value
+		 * @return value at key, string_view into the image for strings
+		 */
+		ValueRef value(const KeyArg &key) const {
+			return ValueCodec::decode(view_.value(KeyCodec::encode(key)));
+		}
+
+		/**
+		 * @param value to search key
+		 * @return key at value, string_view into the image for strings
+		 */
+		KeyRef key(const ValueArg &value) const {
+			return KeyCodec::decode(view_.key(ValueCodec::encode(value)));
+		}
+
+		bool containsKey(const KeyArg &key) const {
+			return view_.containsKey(KeyCodec::encode(key));
+		}
+
+		bool containsValue(const ValueArg &value) const {
+			return view_.containsValue(ValueCodec::encode(value));
+		}
+
+		/**
+		 * @return the image as a PerfectTable2 of bytes
+		 */
+		const PerfectTable2::View &view() const { return view_; }
+
+		/**
+		 * @return bytes of image
+		 */
+		std::span<const char> bytes() const { return { base, length }; }
+
+		/**
+		 * Deserializes the table
+		 */
+		map<K,V> toMap() const {
+			map<K,V> m;
+			for (int i = 0; i < size(); ++i) {
+				const auto [k, v] = view_[i];
+				m.emplace(K(KeyCodec::decode(k)), V(ValueCodec::decode(v)));
+			}
+			return m;
+		}
+
+		Table2<K,V> table() const { return Table2<K,V>(toMap()); }
+	};
+
+}
+
+#endif //__HAD_TABLE2IMAGE_HPP__
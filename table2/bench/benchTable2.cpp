@@ -0,0 +1,201 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+// Table2 benchmarks
+//
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <stopwatch/benchmark.hpp>
+#include "ConcurrentTable2.hpp"
+#include "FlatTable2.hpp"
+#include "MultiTable2.hpp"
+#include "PerfectTable2.hpp"
+#include "Table2.hpp"
+#include "Table2Image.hpp"
+
+using namespace had;
+using std::string;
+
+int main(int argc, char **argv) {
+	return Benchmark::main(argc, argv, [](Benchmark &bench) {
+		const int n = 1000000;
+		const int lookups = 1000;
+		map<int, string> m;
+		for (int i = 0; i < n; ++i) m[i * 7] = "name" + std::to_string(i);
+
+		std::mt19937 gen(0);
+		std::uniform_int_distribution<int> dist(0, n - 1);
+		vector<int> keys(lookups);
+		vector<string> values(lookups);
+		for (int i = 0; i < lookups; ++i) {
+			keys[i] = dist(gen) * 7;
+			values[i] = m[keys[i]];
+		}
+
+		Table2<int, string> table(m);
+		bench.run("Table2 build 1M", [&] {
+			Table2<int, string> t(m);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("Table2::value 1M entries", [&] {
+			for (int k : keys) doNotOptimize(table.value(k));
+		}, 0, lookups);
+
+		bench.run("Table2::key 1M entries", [&] {
+			for (const string &v : values) doNotOptimize(table.key(v));
+		}, 0, lookups);
+
+		//startup from a memory mapped image instead of building the table
+		const string imagePath = "benchTable2.t2i";
+		Table2Image<int, string>::write(imagePath, m);
+		bench.run("Table2Image open 1M", [&] {
+			Table2Image<int, string> t(imagePath);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("Table2Image open 1M without verify", [&] {
+			Table2Image<int, string> t(imagePath, false);
+			doNotOptimize(t);
+		}, 0, n);
+
+		Table2Image<int, string> image(imagePath);
+		bench.run("Table2Image::value 1M entries", [&] {
+			for (int k : keys) doNotOptimize(image.value(k));
+		}, 0, lookups);
+
+		bench.run("Table2Image::key 1M entries", [&] {
+			for (const string &v : values) doNotOptimize(image.key(v));
+		}, 0, lookups);
+		std::remove(imagePath.c_str());
+
+		FlatTable2<int, string> flat(m);
+		bench.run("FlatTable2 build 1M", [&] {
+			FlatTable2<int, string> t(m);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("FlatTable2::value 1M entries", [&] {
+			for (int k : keys) doNotOptimize(flat.value(k));
+		}, 0, lookups);
+
+		bench.run("FlatTable2::key 1M entries", [&] {
+			for (const string &v : values) doNotOptimize(flat.key(v));
+		}, 0, lookups);
+
+		bench.run("FlatTable2::values batched 1M entries", [&] {
+			doNotOptimize(flat.values(keys));
+		}, 0, lookups);
+
+		bench.run("FlatTable2::keys batched 1M entries", [&] {
+			doNotOptimize(flat.keys(values));
+		}, 0, lookups);
+
+		//one-to-many: 1M keys, 1000 keys per value
+		map<int, int> many;
+		for (int i = 0; i < n; ++i) many[i * 7] = i % (n / 1000);
+		std::multimap<int, int> manyRev;
+		for (auto &[k, v] : many) manyRev.emplace(v, k);
+		MultiTable2<int, int> multi(many);
+
+		bench.run("MultiTable2 build 1M", [&] {
+			MultiTable2<int, int> t(many);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("multimap build 1M", [&] {
+			std::multimap<int, int> t;
+			for (auto &[k, v] : many) t.emplace(v, k);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("MultiTable2::keys sum 1000 values", [&] {
+			long sum = 0;
+			for (int k : keys) for (int key : multi.keys(k / 7 % (n / 1000))) sum += key;
+			doNotOptimize(sum);
+		}, 0, lookups);
+
+		bench.run("multimap::equal_range sum 1000 values", [&] {
+			long sum = 0;
+			for (int k : keys) {
+				auto [first, last] = manyRev.equal_range(k / 7 % (n / 1000));
+				for (; first != last; ++first) sum += first->second;
+			}
+			doNotOptimize(sum);
+		}, 0, lookups);
+
+		//string keys and values
+		map<string, string> ms;
+		for (int i = 0; i < n; ++i) ms["code" + std::to_string(i * 7)] = "name" + std::to_string(i);
+		vector<string> codes(lookups);
+		for (int i = 0; i < lookups; ++i) codes[i] = "code" + std::to_string(keys[i]);
+		Table2<string, string> strings(ms);
+		PerfectTable2 perfect(ms);
+
+		bench.run("PerfectTable2 build 1M", [&] {
+			PerfectTable2 t(ms);
+			doNotOptimize(t);
+		}, 0, n);
+
+		bench.run("Table2<string>::value 1M entries", [&] {
+			for (const string &k : codes) doNotOptimize(strings.value(k));
+		}, 0, lookups);
+
+		bench.run("PerfectTable2::value 1M entries", [&] {
+			for (const string &k : codes) doNotOptimize(perfect.value(k));
+		}, 0, lookups);
+
+		bench.run("Table2<string>::key 1M entries", [&] {
+			for (const string &v : values) doNotOptimize(strings.key(v));
+		}, 0, lookups);
+
+		bench.run("PerfectTable2::key 1M entries", [&] {
+			for (const string &v : values) doNotOptimize(perfect.key(v));
+		}, 0, lookups);
+
+		//readers of a ConcurrentTable2 while a writer publishes batches,
+		//each publish copies the 100k entries
+		map<int, string> small;
+		for (int i = 0; i < n / 10; ++i) small[i * 7] = m[i * 7];
+		vector<int> smallKeys(keys);
+		for (int &k : smallKeys) k %= n / 10 * 7;
+		ConcurrentTable2<int, string> concurrent(small);
+		const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned threads = 1; threads <= cores; threads *= 2) {
+			std::atomic<bool> done = false;
+			std::atomic<size_t> total = 0;
+			vector<std::thread> readers;
+			for (unsigned t = 0; t < threads; ++t)
+				readers.emplace_back([&] {
+					auto reader = concurrent.reader();
+					size_t count = 0;
+					while (!done) {
+						for (int k : smallKeys) doNotOptimize(reader->value(k));
+						count += lookups;
+					}
+					total += count;
+				});
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < 4; ++i)
+				concurrent.publish(ConcurrentTable2<int, string>::Batch().set(-1 - i, "new" + std::to_string(i)));
+			done = true;
+			for (auto &t : readers) t.join();
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			std::cout << "ConcurrentTable2::value " << threads << " readers, 4 publishes in "
+					  << elapsed.count() << "s: " << total / elapsed.count() / 1e6 << " M lookups/s\n";
+		}
+
+#ifdef __linux__
+		//cache misses of the pointer chasing reverse lookup
+		PerfCounters pc;
+		StopWatch sw;
+		sw.count(&pc).reset();
+		for (int rep = 0; rep < 100; ++rep)
+			for (const string &v : values) doNotOptimize(table.key(v));
+		sw.lap();
+		std::cout << "Table2::key x" << 100 * lookups << ": " << sw << " " << pc << "\n";
+#endif
+	});
+}
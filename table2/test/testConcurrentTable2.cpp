@@ -0,0 +1,129 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ConcurrentTable2.hpp"
+
+using namespace had;
+using std::string;
+
+TEST_CASE( "ConcurrentTable2", "[ConcurrentTable2]" ) {
+	typedef ConcurrentTable2<int, string> Table;
+
+	const map<int, string> t0 = {
+			{ 1, "One" },
+			{ 3, "Three" },
+			{ 4, "Four" }
+	};
+
+	SECTION("lookups") {
+		Table table(t0);
+		REQUIRE(table.size() == 3);
+		for (const auto & [key, value] : t0) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.key(value) == key);
+		}
+		REQUIRE_THROWS_AS(table.value(2), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(""), std::out_of_range);
+
+		auto reader = table.reader();
+		REQUIRE(reader->value(3) == "Three");
+		REQUIRE((*reader).key("Four") == 4);
+	}
+
+	SECTION("duplicated values are rejected") {
+		REQUIRE_THROWS_AS(Table({ { 1, "One" }, { 2, "One" } }), std::invalid_argument);
+	}
+
+	SECTION("batches are published together") {
+		Table table(t0);
+		const uint64_t v0 = table.version();
+		const Table::Snapshot before = table.snapshot();
+
+		const uint64_t v1 = table.publish(Table::Batch().set(2, "Two").set(1, "Uno").erase(4).erase(9));
+		REQUIRE(v1 > v0);
+		REQUIRE(table.version() == v1);
+		REQUIRE(table.size() == 3);
+		REQUIRE(table.value(1) == "Uno");
+		REQUIRE(table.value(2) == "Two");
+		REQUIRE(table.key("Three") == 3);
+		REQUIRE_THROWS_AS(table.value(4), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key("One"), std::out_of_range);
+
+		//old snapshot is unchanged
+		REQUIRE(before->size() == 3);
+		REQUIRE(before->value(1) == "One");
+		REQUIRE(before->value(4) == "Four");
+
+		//empty batch publishes nothing
+		REQUIRE(table.publish(Table::Batch()) == v1);
+	}
+
+	SECTION("batch breaking one-to-one is rejected") {
+		Table table(t0);
+		auto reader = table.reader();
+		const uint64_t v0 = table.version();
+
+		REQUIRE_THROWS_AS(table.publish(Table::Batch().set(2, "One")), std::invalid_argument);
+		REQUIRE_THROWS_AS(table.publish(Table::Batch().set(5, "Five").set(6, "Five")), std::invalid_argument);
+		REQUIRE_THROWS_AS(table.replace({ { 1, "x" }, { 2, "x" } }), std::invalid_argument);
+		REQUIRE(table.version() == v0);
+		REQUIRE(reader->size() == 3);
+		REQUIRE(reader->key("One") == 1);
+
+		//a value can move to another key in the same batch
+		table.publish(Table::Batch().erase(1).set(2, "One"));
+		REQUIRE(reader->key("One") == 2);
+	}
+
+	SECTION("replace") {
+		Table table(t0);
+		auto reader = table.reader();
+		REQUIRE(reader->size() == 3);
+		table.replace({ { 7, "Seven" } });
+		REQUIRE(reader->size() == 1);
+		REQUIRE(reader->value(7) == "Seven");
+	}
+
+	SECTION("readers see consistent tables while writers publish") {
+		//every published table maps i to "v" + (i + shift) for all i, same shift
+		const int n = 64;
+		auto shifted = [n](int shift) {
+			Table::Batch b;
+			for (int i = 0; i < n; ++i) b.set(i, "v" + std::to_string(i + shift));
+			return b;
+		};
+		map<int, string> m;
+		for (int i = 0; i < n; ++i) m[i] = "v" + std::to_string(i);
+		Table table(m);
+
+		std::atomic<bool> done = false;
+		std::atomic<int> errors = 0;
+		std::vector<std::thread> readers;
+		for (int r = 0; r < 4; ++r)
+			readers.emplace_back([&] {
+				auto reader = table.reader();
+				while (!done) {
+					const Table2<int, string> &t = reader.get();
+					const int shift = std::stoi(t.value(0).substr(1));
+					for (int i = 0; i < n; ++i) {
+						const string v = "v" + std::to_string(i + shift);
+						if (t.value(i) != v || t.key(v) != i) ++errors;
+					}
+				}
+			});
+
+		for (int shift = 1; shift <= 200; ++shift) table.publish(shifted(shift));
+		done = true;
+		for (auto &t : readers) t.join();
+
+		REQUIRE(errors == 0);
+		REQUIRE(table.value(0) == "v200");
+		REQUIRE(table.key("v263") == 63);
+	}
+}
@@ -0,0 +1,70 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "../ConstTable2.hpp"
+
+using namespace had;
+using std::string_view;
+
+enum Enum { A, B, C, D };
+
+constexpr auto t0 = makeConstTable2<int, string_view>({
+		{ 4, "Four" },
+		{ 1, "One" },
+		{ 3, "Three" }
+});
+
+constexpr auto t1 = makeConstTable2<Enum, string_view>({
+		{ A, "One" },
+		{ C, "Three" },
+		{ D, "Four" }
+});
+
+//lookups with constant arguments are done at compile time
+static_assert(t0.size() == 3);
+static_assert(t0.value(1) == "One");
+static_assert(t0.key("Four") == 4);
+static_assert(t1.key(string_view("Three")) == C);
+static_assert(!t0.containsKey(2));
+static_assert(!t0.containsValue("Two"));
+//no startup code: trivially copyable data
+static_assert(std::is_trivially_copyable_v<decltype(t0)>);
+
+//compile errors:
+//  constexpr auto dupKey = makeConstTable2<int, int>({ { 1, 1 }, { 1, 2 } });
+//  constexpr auto dupValue = makeConstTable2<int, int>({ { 1, 1 }, { 2, 1 } });
+//  static_assert(t0.value(2) == "Two");
+
+TEST_CASE( "ConstTable2", "[ConstTable2]" ) {
+
+	SECTION("test t0") {
+		const std::pair<int, string_view> pairs[] = { { 1, "One" }, { 3, "Three" }, { 4, "Four" } };
+		for (const auto & [key, value] : pairs) {
+			REQUIRE(t0.value(key) == value);
+			REQUIRE(t0.key(value) == key);		//reverse
+		}
+
+		//Non existant, at runtime
+		volatile int two = 2;
+		REQUIRE_THROWS_AS(t0.value(two), std::out_of_range);
+		REQUIRE_THROWS_AS(t0.key(std::string("")), std::out_of_range);
+	}
+
+	SECTION("test t1") {
+		REQUIRE(t1.value(A) == "One");
+		REQUIRE(t1.key(std::string("Four")) == D);
+		REQUIRE_THROWS_AS(t1.value(B), std::out_of_range);
+	}
+
+	SECTION("Single entry") {
+		constexpr auto t = makeConstTable2<char, int>({ { 'a', 97 } });
+		static_assert(t.key(97) == 'a');
+		REQUIRE(t.value('a') == 97);
+		REQUIRE_FALSE(t.containsKey('b'));
+	}
+}
@@ -0,0 +1,111 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include "../FlatTable2.hpp"
+
+using namespace had;
+using std::string;
+
+TEST_CASE( "FlatTable2", "[FlatTable2]" ) {
+	enum Enum { A, B, C, D };
+
+	const map<int, string> t0 = {
+			{ 1, "One" },
+			{3, "Three" },
+			{ 4, "Four" }
+	};
+
+	const map<Enum, string> t1 = {
+			{ A, "One" },
+			{ C, "Three" },
+			{ D, "Four" }
+	};
+
+
+	SECTION("test t0") {
+		FlatTable2<int, string> table(t0);
+
+		REQUIRE(table.size() == 3);
+		for (const auto & [key, value] : t0) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.key(value) == key);		//reverse
+		}
+
+		//Non existant
+		REQUIRE_THROWS_AS(table.value(2),std::out_of_range);
+		REQUIRE_THROWS_AS(table.value(0),std::out_of_range);
+		REQUIRE_THROWS_AS(table.value(5),std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(""),std::out_of_range);
+		REQUIRE_THROWS_AS(table.key("Zero"),std::out_of_range);
+	}
+
+	SECTION("test t1") {
+		FlatTable2<Enum, string> table(t1);
+
+		for (const auto & [key, value] : t1) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.key(value) == key);		//reverse
+		}
+
+		//Non existant
+		REQUIRE_THROWS_AS(table.value(B),std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(""),std::out_of_range);
+	}
+
+	SECTION("Heterogeneous lookups") {
+		FlatTable2<string, int> table(vector<std::pair<string, int>>{ { "b", 2 }, { "a", 1 }, { "c", 3 } });
+		REQUIRE(table.value(std::string_view("b")) == 2);
+		REQUIRE(table.value("c") == 3);
+		REQUIRE(table.key(1) == "a");
+		REQUIRE(table.containsKey(std::string_view("a")));
+		REQUIRE_FALSE(table.containsKey("d"));
+		REQUIRE_FALSE(table.containsValue(4));
+
+		REQUIRE_THROWS_AS((FlatTable2<int, int>(vector<std::pair<int, int>>{ { 1, 1 }, { 1, 2 } })), std::invalid_argument);
+		FlatTable2<int, int> empty(map<int, int>{});
+		REQUIRE(empty.size() == 0);
+		REQUIRE_THROWS_AS(empty.value(1), std::out_of_range);
+		REQUIRE(empty.values(vector<int>{ 1, 2 }) == vector<const int*>{ nullptr, nullptr });
+	}
+
+	SECTION("Large tables, single and batched lookups") {
+		std::mt19937 gen(0);
+		//all sizes around full and partial last levels
+		for (int n : { 1, 2, 3, 7, 8, 9, 15, 16, 17, 100, 1023, 1024, 1025, 5000 }) {
+			map<int, string> m;
+			while ((int) m.size() < n) {
+				const int k = gen() % (4 * n) * 2;   //even keys
+				m[k] = "v" + std::to_string(k);
+			}
+			FlatTable2<int, string> table(m);
+
+			vector<int> keys;
+			vector<string> values;
+			for (int k = -1; k <= 8 * n + 1; ++k) {
+				keys.push_back(k);
+				values.push_back("v" + std::to_string(k));
+			}
+			vector<const string*> vs = table.values(keys);
+			vector<const int*> ks = table.keys(values);
+			for (size_t i = 0; i < keys.size(); ++i) {
+				auto it = m.find(keys[i]);
+				if (it == m.end()) {
+					REQUIRE(vs[i] == nullptr);
+					REQUIRE(ks[i] == nullptr);
+					REQUIRE_FALSE(table.containsKey(keys[i]));
+				}
+				else {
+					REQUIRE(table.value(keys[i]) == it->second);
+					REQUIRE(table.key(it->second) == keys[i]);
+					REQUIRE(*vs[i] == it->second);
+					REQUIRE(*ks[i] == keys[i]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,110 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../MultiTable2.hpp"
+
+using namespace had;
+using std::string;
+
+TEST_CASE( "MultiTable2", "[MultiTable2]" ) {
+	enum Enum { A, B, C, D, E };
+
+	const map<int, string> t0 = {
+			{ 1, "Odd" },
+			{ 2, "Even" },
+			{ 3, "Odd" },
+			{ 4, "Even" },
+			{ 5, "Odd" },
+			{ 6, "Six" }
+	};
+
+	auto keys = [](std::span<const int> s) { return std::vector<int>(s.begin(), s.end()); };
+
+	SECTION("lookups") {
+		MultiTable2<int, string> table(t0);
+		REQUIRE(table.size() == 6);
+		REQUIRE(table.valueCount() == 3);
+
+		for (const auto & [key, value] : t0) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.containsKey(key));
+			REQUIRE(table.containsValue(value));
+		}
+		REQUIRE(keys(table.keys("Odd")) == std::vector<int>{ 1, 3, 5 });
+		REQUIRE(keys(table.keys(std::string_view("Even"))) == std::vector<int>{ 2, 4 });
+		REQUIRE(keys(table.keys("Six")) == std::vector<int>{ 6 });
+
+		//Non existant
+		REQUIRE_THROWS_AS(table.value(7), std::out_of_range);
+		REQUIRE(table.keys("None").empty());
+		REQUIRE(table.keys("").empty());
+		REQUIRE(table.keys("Zzz").empty());
+		REQUIRE(!table.containsKey(0));
+		REQUIRE(!table.containsValue("None"));
+	}
+
+	SECTION("postings are contiguous") {
+		MultiTable2<int, string> table(t0);
+		const auto even = table.keys("Even"), odd = table.keys("Odd"), six = table.keys("Six");
+		REQUIRE(even.data() + even.size() == odd.data());
+		REQUIRE(odd.data() + odd.size() == six.data());
+	}
+
+	SECTION("key range") {
+		MultiTable2<int, string> table(t0);
+		std::vector<std::pair<int, string>> got;
+		for (const auto & [key, value] : table.keyRange(2, 5)) got.push_back({ key, value });
+		REQUIRE(got == std::vector<std::pair<int, string>>{ { 2, "Even" }, { 3, "Odd" }, { 4, "Even" } });
+		REQUIRE(table.keyRange(2, 5).size() == 3);
+		REQUIRE(table.keyRange(5, 2).empty());
+		REQUIRE(table.keyRange(7, 9).empty());
+		REQUIRE(table.keyRange(0, 100).size() == 6);
+
+		map<int, string> all(table.begin(), table.end());
+		REQUIRE(all == t0);
+	}
+
+	SECTION("value range") {
+		MultiTable2<int, string> table(t0);
+		const auto r = table.valueRange("Even", "Six");
+		REQUIRE(r.size() == 2);
+		std::vector<string> values;
+		for (const auto & [value, ks] : r) {
+			values.push_back(value);
+			REQUIRE(ks.size() == (value == "Even" ? 2 : 3));
+		}
+		REQUIRE(values == std::vector<string>{ "Even", "Odd" });
+		REQUIRE(keys(r.keys()) == std::vector<int>{ 2, 4, 1, 3, 5 });
+
+		REQUIRE(table.valueRange("P", "S").empty());
+		REQUIRE(table.valueRange("P", "S").keys().empty());
+		REQUIRE(keys(table.valueRange("P", "zzz").keys()) == std::vector<int>{ 6 });
+	}
+
+	SECTION("enum keys, unsorted pairs") {
+		MultiTable2<Enum, int> table(std::vector<std::pair<Enum, int>>{ { E, 1 }, { A, 0 }, { C, 1 }, { B, 0 } });
+		REQUIRE(table.value(C) == 1);
+		const auto zero = table.keys(0);
+		REQUIRE(std::vector<Enum>(zero.begin(), zero.end()) == std::vector<Enum>{ A, B });
+		REQUIRE(table.keys(1).size() == 2);
+		REQUIRE_THROWS_AS(table.value(D), std::out_of_range);
+	}
+
+	SECTION("duplicated keys") {
+		REQUIRE_THROWS_AS((MultiTable2<int, int>(std::vector<std::pair<int, int>>{ { 1, 1 }, { 1, 2 } })), std::invalid_argument);
+	}
+
+	SECTION("empty") {
+		MultiTable2<int, int> table(map<int, int>{});
+		REQUIRE(table.size() == 0);
+		REQUIRE(table.keys(1).empty());
+		REQUIRE(table.keyRange(0, 10).empty());
+		REQUIRE(table.valueRange(0, 10).keys().empty());
+		REQUIRE_THROWS_AS(table.value(1), std::out_of_range);
+	}
+}
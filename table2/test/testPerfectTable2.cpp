@@ -0,0 +1,88 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include "../PerfectTable2.hpp"
+
+using namespace had;
+using std::string;
+
+TEST_CASE( "PerfectTable2", "[PerfectTable2]" ) {
+
+	const map<string, string> t0 = {
+			{ "1", "One" },
+			{ "3", "Three" },
+			{ "4", "Four" }
+	};
+
+	SECTION("test t0") {
+		PerfectTable2 table(t0);
+
+		REQUIRE(table.size() == 3);
+		for (const auto & [key, value] : t0) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.key(value) == key);		//reverse
+		}
+
+		//Non existant
+		REQUIRE_THROWS_AS(table.value("2"), std::out_of_range);
+		REQUIRE_THROWS_AS(table.value(""), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(""), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key("one"), std::out_of_range);
+	}
+
+	SECTION("Edge cases") {
+		PerfectTable2 empty(map<string, string>{});
+		REQUIRE(empty.size() == 0);
+		REQUIRE_FALSE(empty.containsKey("a"));
+		REQUIRE_FALSE(empty.view().containsValue(""));
+
+		PerfectTable2 one(map<string, string>{ { "", string("\0x", 2) } });
+		REQUIRE(one.value("") == string("\0x", 2));
+		REQUIRE(one.key(string("\0x", 2)) == "");
+
+		REQUIRE_THROWS_AS(PerfectTable2(map<string, string>{ { "a", "x" }, { "b", "x" } }), std::invalid_argument);
+	}
+
+	SECTION("Large table") {
+		const int n = 100000;
+		map<string, string> m;
+		for (int i = 0; i < n; ++i) m["key" + std::to_string(i)] = "a longer value string number " + std::to_string(i);
+		PerfectTable2 table(m);
+		PerfectTable2::View view = table.view();
+
+		REQUIRE(view.size() == n);
+		for (const auto & [key, value] : m) {
+			REQUIRE(view.value(key) == value);
+			REQUIRE(view.key(value) == key);
+		}
+		for (int i = n; i < n + 1000; ++i) {
+			REQUIRE_FALSE(view.containsKey("key" + std::to_string(i)));
+			REQUIRE_FALSE(view.containsValue("value" + std::to_string(i)));
+		}
+		//8 bits per key for each direction
+		REQUIRE(table.hashBytes() <= 2 * n + 16);
+
+		//every pair exactly once in slot order
+		map<string, string> back;
+		for (int i = 0; i < n; ++i) back.emplace(view[i].first, view[i].second);
+		REQUIRE(back == m);
+	}
+
+	SECTION("Generated header") {
+		PerfectTable2 table(map<string, string>{ { "quote\"", "back\\slash" }, { "new\nline", "tri??graph" }, { "k", "\x01\x7f\xff" } });
+		std::stringstream out;
+		table.writeHeader(out, "names");
+		const string h = out.str();
+		REQUIRE(h.find("#include <table2/PerfectTable2.hpp>") != string::npos);
+		REQUIRE(h.find("inline constexpr uint32_t names_keyPilots[]") != string::npos);
+		REQUIRE(h.find("inline constexpr had::PerfectTable2::View names(") != string::npos);
+		REQUIRE(h.find("quote\\\"") != string::npos);
+		REQUIRE(h.find("new\\012line") != string::npos);
+		REQUIRE(h.find("tri\\077\\077graph") != string::npos);
+		REQUIRE(h.find("\\001\\177\\377") != string::npos);
+	}
+}
@@ -4,6 +4,9 @@
 
 #include <catch2/catch.hpp>
 #include <sstream>
+#include <string_view>
+#include <vector>
+#include <appTest/AllocCounter.hpp>
 #include "../Table2.hpp"
 
 using namespace had;
@@ -52,4 +55,86 @@ TEST_CASE( "Table2", "[Table2]" ) {
 		REQUIRE_THROWS_AS(table.key(""),std::out_of_range);
 	}
 
+	SECTION("Heterogeneous lookups do not allocate") {
+		map<string, string> m;
+		for (int i = 0; i < 100; ++i)
+			m["a long key, no small string optimization " + std::to_string(i)] = "a long value, no small string optimization " + std::to_string(i);
+		Table2<string, string> table(m);
+
+		const size_t before = allocations;
+		REQUIRE(table.value(std::string_view("a long key, no small string optimization 42")) == "a long value, no small string optimization 42");
+		REQUIRE(table.key("a long value, no small string optimization 7") == "a long key, no small string optimization 7");
+		REQUIRE(table.key(std::string_view("a long value, no small string optimization 99")) == "a long key, no small string optimization 99");
+		REQUIRE(allocations == before);
+		REQUIRE_THROWS_AS(table.value("missing"), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(std::string_view("missing")), std::out_of_range);
+	}
+
+	SECTION("Move and range constructors") {
+		map<int, string> m = t0;
+		size_t before = allocations;
+		Table2<int, string> moved(std::move(m));
+		//one array each direction, keys and values are moved,
+		//and the merge buffer of sorting values
+		REQUIRE(allocations <= before + 3);
+		REQUIRE(m.empty());
+		REQUIRE(moved.size() == 3);
+		REQUIRE(moved.value(3) == "Three");
+		REQUIRE(moved.key("Four") == 4);
+
+		//values in key order: no sort
+		const map<int, string> ordered = { { 1, "a" }, { 2, "b" }, { 3, "c" } };
+		before = allocations;
+		Table2<int, string> copied(ordered);
+		REQUIRE(allocations == before + 2);
+
+		std::vector<std::pair<int, string>> sorted(ordered.begin(), ordered.end());
+		before = allocations;
+		Table2<int, string> ranged(sorted.begin(), sorted.end());
+		REQUIRE(allocations == before + 2);
+		for (const auto & [key, value] : ordered) {
+			REQUIRE(ranged.value(key) == value);
+			REQUIRE(ranged.key(value) == key);
+		}
+
+		ranged = Table2<int, string>(t0.begin(), t0.end());
+		for (const auto & [key, value] : t0) {
+			REQUIRE(ranged.value(key) == value);
+			REQUIRE(ranged.key(value) == key);
+		}
+
+		//unsorted, first of duplicated keys is kept
+		std::vector<std::pair<int, string>> unsorted = { { 4, "Four" }, { 1, "One" }, { 4, "Other" }, { 3, "Three" } };
+		Table2<int, string> shuffled(unsorted.begin(), unsorted.end());
+		REQUIRE(shuffled.size() == 3);
+		REQUIRE(shuffled.value(4) == "Four");
+		REQUIRE(shuffled.key("Three") == 3);
+		REQUIRE_THROWS_AS(shuffled.key("Other"), std::out_of_range);
+		REQUIRE(map<int, string>(shuffled.begin(), shuffled.end()) == t0);
+	}
+
+	SECTION("Copies do not point to the original") {
+		Table2<int, string> *original = new Table2<int, string>(t0);
+		Table2<int, string> copy(*original);
+		Table2<int, string> assigned(map<int, string>{});
+		assigned = *original;
+		delete original;
+		REQUIRE(copy.key("One") == 1);
+		REQUIRE(assigned.key("Three") == 3);
+	}
+
+	SECTION("Duplicated values") {
+		Table2<int, string> table(map<int, string>{ { 1, "x" }, { 2, "y" }, { 3, "x" } });
+		REQUIRE(table.value(1) == "x");
+		REQUIRE(table.key("x") == 3);    //last key of duplicated values
+		REQUIRE(table.key("y") == 2);
+		REQUIRE(!table.oneToOne());
+		REQUIRE(Table2<int, string>(t0).oneToOne());
+	}
+
+	SECTION("Iteration in key order") {
+		Table2<int, string> table(t0);
+		REQUIRE(map<int, string>(table.begin(), table.end()) == t0);
+	}
+
 }
@@ -0,0 +1,168 @@
+//
+// Created by hdaniel on 19/10/26.
+//
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include "../Table2Image.hpp"
+
+using namespace had;
+using std::string;
+
+//8 byte aligned copy of an image in memory
+static std::vector<uint64_t> aligned(const string &image) {
+	std::vector<uint64_t> buf((image.size() + 7) / 8);
+	std::memcpy(buf.data(), image.data(), image.size());
+	return buf;
+}
+
+TEST_CASE( "Table2Image", "[Table2Image]" ) {
+	const string path = "testTable2Image.t2i";
+
+	const map<int, string> t0 = {
+			{ 1, "One" },
+			{ 3, "Three" },
+			{ 4, "Four" }
+	};
+
+	SECTION("mapped file") {
+		Table2Image<int, string>::write(path, t0);
+		Table2Image<int, string> table(path);
+		REQUIRE(table.size() == 3);
+		for (const auto & [key, value] : t0) {
+			REQUIRE(table.value(key) == value);
+			REQUIRE(table.key(value) == key);
+			REQUIRE(table.containsKey(key));
+			REQUIRE(table.containsValue(value));
+		}
+		REQUIRE_THROWS_AS(table.value(2), std::out_of_range);
+		REQUIRE_THROWS_AS(table.key(""), std::out_of_range);
+		REQUIRE(!table.containsValue("Two"));
+
+		//string values point into the image
+		const string_view v = table.value(3);
+		REQUIRE(v.data() >= table.bytes().data());
+		REQUIRE(v.data() < table.bytes().data() + table.bytes().size());
+
+		//both directions of serialization
+		REQUIRE(table.toMap() == t0);
+		REQUIRE(table.table().key("Four") == 4);
+
+		//moved tables keep the mapping
+		Table2Image<int, string> moved(std::move(table));
+		REQUIRE(moved.value(1) == "One");
+		std::remove(path.c_str());
+		REQUIRE(moved.key("Three") == 3);
+	}
+
+	SECTION("strings and integers") {
+		map<string, string> ss;
+		map<string, uint64_t> si;
+		for (int i = 0; i < 1000; ++i) {
+			ss["key " + std::to_string(i)] = "value " + std::to_string(i);
+			si["key " + std::to_string(i)] = 1000000007ull * i;
+		}
+		std::ostringstream os0, os1;
+		Table2Image<string, string>::write(os0, ss);
+		Table2Image<string, uint64_t>::write(os1, si);
+		const auto b0 = aligned(os0.str()), b1 = aligned(os1.str());
+		Table2Image<string, string> t0(std::span<const char>(reinterpret_cast<const char*>(b0.data()), os0.str().size()));
+		Table2Image<string, uint64_t> t1(std::span<const char>(reinterpret_cast<const char*>(b1.data()), os1.str().size()));
+		REQUIRE(t0.value("key 42") == "value 42");
+		REQUIRE(t0.key(string("value 999")) == "key 999");
+		REQUIRE(t1.value("key 7") == 7000000049ull);
+		REQUIRE(t1.key(1000000007ull * 500) == "key 500");
+		REQUIRE(!t1.containsValue(1));
+		REQUIRE(t0.toMap() == ss);
+		REQUIRE(t1.toMap() == si);
+	}
+
+	SECTION("empty table") {
+		std::ostringstream os;
+		Table2Image<int, int>::write(os, {});
+		const auto b = aligned(os.str());
+		Table2Image<int, int> table(std::span<const char>(reinterpret_cast<const char*>(b.data()), os.str().size()));
+		REQUIRE(table.size() == 0);
+		REQUIRE(!table.containsKey(0));
+		REQUIRE_THROWS_AS(table.value(0), std::out_of_range);
+	}
+
+	SECTION("duplicated values are rejected") {
+		std::ostringstream os;
+		REQUIRE_THROWS_AS((Table2Image<int, int>::write(os, { { 1, 5 }, { 2, 5 } })), std::invalid_argument);
+		REQUIRE_THROWS_AS((Table2Image<int, int>::write(path, Table2<int, int>(map<int, int>{ { 1, 5 }, { 2, 5 } }))),
+						  std::invalid_argument);
+	}
+
+	SECTION("invalid images are rejected") {
+		std::ostringstream os;
+		Table2Image<int, string>::write(os, t0);
+		const string good = os.str();
+		auto open = [](const string &image, bool verify = true) {
+			const auto b = aligned(image);
+			Table2Image<int, string>(std::span<const char>(reinterpret_cast<const char*>(b.data()), image.size()), verify);
+		};
+		REQUIRE_NOTHROW(open(good));
+
+		string bad = good;
+		bad[bad.size() - 9] ^= 1;        //in the arena
+		REQUIRE_THROWS_AS(open(bad), std::runtime_error);
+		REQUIRE_NOTHROW(open(bad, false));
+
+		bad = good;
+		bad[0] = 'X';
+		REQUIRE_THROWS_AS(open(bad, false), std::runtime_error);
+
+		REQUIRE_THROWS_AS(open(good.substr(0, good.size() - 8), false), std::runtime_error);
+		REQUIRE_THROWS_AS(open(good.substr(0, 16), false), std::runtime_error);
+
+		//other key or value types
+		const auto b = aligned(good);
+		const std::span<const char> bytes(reinterpret_cast<const char*>(b.data()), good.size());
+		REQUIRE_THROWS_AS((Table2Image<string, string>(bytes)), std::runtime_error);
+		REQUIRE_THROWS_AS((Table2Image<int64_t, string>(bytes)), std::runtime_error);
+
+		REQUIRE_THROWS_AS((Table2Image<int, string>("missing.t2i")), std::runtime_error);
+	}
+
+	SECTION("concurrent writers of one path") {
+		const string dir = "testTable2Image.dir";
+		std::filesystem::remove_all(dir);
+		std::filesystem::create_directory(dir);
+		const string file = dir + "/t.t2i";
+		const int nthreads = 4;
+		std::vector<map<int, string>> maps(nthreads);
+		for (int t = 0; t < nthreads; ++t)
+			for (int i = 0; i < 1000; ++i) maps[t][i] = std::to_string(t) + "-" + std::to_string(i);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < nthreads; ++t)
+			threads.emplace_back([&, t] {
+				for (int r = 0; r < 5; ++r) Table2Image<int, string>::write(file, maps[t]);
+			});
+		for (auto &t : threads) t.join();
+
+		//one complete image, no temporary files left
+		Table2Image<int, string> table(file);
+		REQUIRE(table.size() == 1000);
+		const string first(table.value(0));
+		const int t = first[0] - '0';
+		REQUIRE((t >= 0 && t < nthreads));
+		for (auto & [key, value] : maps[t]) REQUIRE(table.value(key) == value);
+		REQUIRE(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 1);
+
+		struct stat st;
+		REQUIRE(stat(file.c_str(), &st) == 0);
+		REQUIRE((st.st_mode & 0777) == 0644);
+
+		REQUIRE_THROWS_AS((Table2Image<int, string>::write(dir + "/missing/t.t2i", t0)), std::runtime_error);
+		std::filesystem::remove_all(dir);
+	}
+}